@@ -0,0 +1,92 @@
+// 时间窗去背景的基准：窗口长度从 5 到 201，对比逐采样重新求窗口和的原实现与
+// RadarKernels 中按道累加前缀和的实现，并给出两者的最大差值。
+// 同时给出同样基于前缀和的自动增益控制的耗时。用法：running_sum_bench [采样数] [道数] [重复次数]
+
+#include "ParallelScheduler.h"
+#include "RadarKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 原实现：每个采样重新累加整个窗口，内层按行访问
+void removeBackgroundReference(const Eigen::MatrixXf &scan, Eigen::MatrixXf &result, const int windowSize)
+{
+    const int numTraces = int(scan.cols());
+    const int numSamples = int(scan.rows());
+    const int halfWindow = windowSize / 2;
+    result = scan;
+    ParallelScheduler::instance().parallelFor(0, numSamples, 8, [&](const std::int64_t first, const std::int64_t last) {
+        for (int t = int(first); t < int(last); ++t) {
+            const int start = std::max(0, t - halfWindow);
+            const int end = std::min(numSamples - 1, t + halfWindow);
+            for (int i = 0; i < numTraces; ++i) {
+                float sum = 0.0f;
+                for (int w = start; w <= end; ++w) {
+                    sum += scan(w, i);
+                }
+                result(t, i) = scan(t, i) - sum / float(end - start + 1);
+            }
+        }
+    });
+}
+
+// 重复 repeats 次取最短耗时（秒），每次计时前由 reset 恢复输入
+template<typename Reset, typename Body>
+double bestSeconds(const int repeats, Reset &&reset, Body &&body)
+{
+    double best = 1e300;
+    for (int i = 0; i < repeats; ++i) {
+        reset();
+        const auto start = Clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int samples = argc > 1 ? std::max(1, std::atoi(argv[1])) : 512;
+    const int traces = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4000;
+    const int repeats = argc > 3 ? std::max(1, std::atoi(argv[3])) : 5;
+
+    const Eigen::MatrixXf scan = Eigen::MatrixXf::Random(samples, traces);
+    Eigen::MatrixXf reference;
+    Eigen::MatrixXf work;
+    const auto reset = [&]() { work = scan; };
+
+    std::printf("%d samples x %d traces, best of %d runs, %d workers\n",
+                samples,
+                traces,
+                repeats,
+                ParallelScheduler::instance().workerCount());
+    std::printf("%8s %14s %14s %9s %12s %14s\n", "window", "reference ms", "running ms", "speedup", "max error", "agc ms");
+
+    for (const int window : {5, 11, 21, 51, 101, 201}) {
+        const double referenceSeconds = bestSeconds(repeats, []() {}, [&]() {
+            removeBackgroundReference(scan, reference, window);
+        });
+        const double runningSeconds = bestSeconds(repeats, reset, [&]() {
+            RadarKernels::removeBackground(work, window);
+        });
+        const double maxError = (work - reference).cwiseAbs().maxCoeff();
+        const double agcSeconds = bestSeconds(repeats, reset, [&]() {
+            RadarKernels::automaticGainControl(work, window);
+        });
+        std::printf("%8d %14.3f %14.3f %8.1fx %12.3g %14.3f\n",
+                    window,
+                    referenceSeconds * 1e3,
+                    runningSeconds * 1e3,
+                    referenceSeconds / runningSeconds,
+                    maxError,
+                    agcSeconds * 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+// int16 采样到电压值转换的基准：以原先解析时使用的 TensorMap::unaryExpr(digital_to_voltage_calibrated)
+// 为基线，分别计时 AVX2 / SSE2 / 标量内核与按切片并行的转换，给出相对基线的加速比，
+// 每种内核的结果与基线逐个比较。用法：sample_conversion_bench [采样数] [重复次数]
+
+#include "ParallelScheduler.h"
+#include "SampleConversion.h"
+#include "VolumeStorage.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// 每个采样读 2 字节、写 4 字节
+constexpr double kBytesPerSample = sizeof(int16_t) + sizeof(float);
+// 并行转换时每个切片的采样数，与 512 采样 x 30 通道的数据体相同
+constexpr std::int64_t kSliceSamples = 512 * 30;
+
+// 原先的逐采样转换，每次调用重新计算比例因子与截距
+inline float digital_to_voltage_calibrated(int digital_value,
+                                           int D_min_meas = -32768,
+                                           int D_max_meas = 32767,
+                                           float delta_a = 0.0,
+                                           float delta_b = 0.0)
+{
+    const float a = (D_max_meas - D_min_meas) / 40.0;
+    const float b = D_min_meas + 20.0 * a;
+    const float a_adj = a + delta_a;
+    const float b_adj = b + delta_b;
+    return (digital_value - b_adj) / a_adj;
+}
+
+// 重复 repeats 次取最短耗时（秒）
+template<typename Body>
+double bestSeconds(const int repeats, Body &&body)
+{
+    double best = 1e300;
+    for (int i = 0; i < repeats; ++i) {
+        const auto start = Clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+// baselineSeconds 为基线转换同样数量采样的耗时
+void report(const char *name,
+            const std::int64_t count,
+            const double seconds,
+            const double baselineSeconds,
+            const double maxError)
+{
+    std::printf("%-16s %10.3f ms %8.2f GB/s %8.2f Gsamples/s %7.2fx  max error %g\n",
+                name,
+                seconds * 1e3,
+                count * kBytesPerSample / seconds / 1e9,
+                count / seconds / 1e9,
+                baselineSeconds / seconds,
+                maxError);
+}
+
+double maxDifference(const std::vector<float> &a, const std::vector<float> &b)
+{
+    double error = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        error = std::max(error, double(std::abs(a[i] - b[i])));
+    }
+    return error;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const std::int64_t count = argc > 1 ? std::max(1LL, std::atoll(argv[1])) : 64LL * 1024 * 1024;
+    const int repeats = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10;
+
+    std::vector<int16_t> samples(static_cast<size_t>(count));
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> distribution(-32768, 32767);
+    for (int16_t &sample : samples) {
+        sample = int16_t(distribution(random));
+    }
+    const VoltageCalibration calibration = VoltageCalibration::fromDigitalRange();
+
+    std::printf("%lld samples, best of %d runs, dispatch selects \"%s\", %d workers\n",
+                static_cast<long long>(count),
+                repeats,
+                sampleConversionKernelName(),
+                ParallelScheduler::instance().workerCount());
+
+    // 基线：与原先解析时相同，逐采样调用 digital_to_voltage_calibrated
+    std::vector<float> reference(static_cast<size_t>(count));
+    const Eigen::TensorMap<Eigen::Tensor<const int16_t, 1>> input(samples.data(), count);
+    Eigen::TensorMap<Eigen::Tensor<float, 1>> referenceMap(reference.data(), count);
+    const double baselineSeconds = bestSeconds(repeats, [&]() {
+        referenceMap = input.unaryExpr([](int16_t val) { return digital_to_voltage_calibrated(val); });
+    });
+    report("unaryExpr", count, baselineSeconds, baselineSeconds, 0.0);
+
+    std::vector<float> out(static_cast<size_t>(count));
+    for (const char *kernel : {"scalar", "sse2", "avx2"}) {
+        if (!convertSamplesToVoltageWith(kernel, samples.data(), out.data(), count, calibration)) {
+            std::printf("%-16s not supported on this CPU\n", kernel);
+            continue;
+        }
+        const double seconds = bestSeconds(repeats, [&]() {
+            convertSamplesToVoltageWith(kernel, samples.data(), out.data(), count, calibration);
+        });
+        report(kernel, count, seconds, baselineSeconds, maxDifference(reference, out));
+    }
+
+    const std::int64_t slices = count / kSliceSamples;
+    if (slices > 0) {
+        const std::int64_t sliceCount = slices * kSliceSamples;
+        std::fill(out.begin(), out.end(), 0.0f);
+        const double seconds = bestSeconds(repeats, [&]() {
+            convertSlicesToVoltage(samples.data(), out.data(), kSliceSamples, slices, calibration);
+        });
+        out.resize(size_t(sliceCount));
+        reference.resize(size_t(sliceCount));
+        report("parallel slices",
+               sliceCount,
+               seconds,
+               baselineSeconds * double(sliceCount) / double(count),
+               maxDifference(reference, out));
+    }
+    return 0;
+}
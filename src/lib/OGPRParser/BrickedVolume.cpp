@@ -0,0 +1,198 @@
+#include "BrickedVolume.h"
+#include "ParallelScheduler.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+// 每个并行区间的道数（切片或通道），区间内逐道复制各砖块行
+constexpr std::int64_t kSweepGrain = 64;
+} // namespace
+
+BrickedVolume::BrickedVolume(const int brickSize)
+    : m_brickSize(std::max(1, brickSize))
+{}
+
+void BrickedVolume::build(const Eigen::Tensor<float, 3> &volume)
+{
+    allocate(volume.dimension(0), volume.dimension(1), volume.dimension(2));
+    fillSlab(volume.data(), 0, m_slices);
+}
+
+void BrickedVolume::build(const VolumeStorage<int16_t> &storage)
+{
+    allocate(storage.samplesCount(), storage.channelsCount(), storage.slicesCount());
+    // 逐切片转换，临时内存只有一个切片
+    Eigen::MatrixXf slice;
+    for (Index t = 0; t < m_slices; ++t) {
+        storage.extractTScan(t, slice);
+        fillSlab(slice.data(), t, 1);
+    }
+}
+
+void BrickedVolume::clear()
+{
+    m_samples = m_channels = m_slices = 0;
+    m_bricksS = m_bricksC = m_bricksT = 0;
+    m_bricks.clear();
+    m_bricks.shrink_to_fit();
+}
+
+bool BrickedVolume::isEmpty() const
+{
+    return m_bricks.empty();
+}
+
+int BrickedVolume::brickSize() const
+{
+    return m_brickSize;
+}
+
+BrickedVolume::Index BrickedVolume::samplesCount() const
+{
+    return m_samples;
+}
+
+BrickedVolume::Index BrickedVolume::channelsCount() const
+{
+    return m_channels;
+}
+
+BrickedVolume::Index BrickedVolume::slicesCount() const
+{
+    return m_slices;
+}
+
+BrickedVolume::Index BrickedVolume::residentBytes() const
+{
+    return Index(m_bricks.size() * sizeof(float));
+}
+
+void BrickedVolume::allocate(const Index samples, const Index channels, const Index slices)
+{
+    const Index b = m_brickSize;
+    m_samples = samples;
+    m_channels = channels;
+    m_slices = slices;
+    m_bricksS = (samples + b - 1) / b;
+    m_bricksC = (channels + b - 1) / b;
+    m_bricksT = (slices + b - 1) / b;
+    // 边缘砖块补零
+    m_bricks.assign(size_t(m_bricksS * m_bricksC * m_bricksT * b * b * b), 0.0f);
+}
+
+BrickedVolume::Index BrickedVolume::brickOffset(
+    const Index brickSample, const Index brickChannel, const Index brickSlice) const
+{
+    const Index b = m_brickSize;
+    return ((brickSlice * m_bricksC + brickChannel) * m_bricksS + brickSample) * b * b * b;
+}
+
+void BrickedVolume::fillSlab(const float *slab, const Index firstSlice, const Index count)
+{
+    const Index b = m_brickSize;
+    const Index sweeps = count * m_channels;
+
+    // 每个 (切片, 通道) 的采样写入不同砖块行，互不重叠
+    ParallelScheduler::instance().parallelFor(0, sweeps, kSweepGrain, [&](const Index first, const Index last) {
+        for (Index sweep = first; sweep < last; ++sweep) {
+            const Index t = firstSlice + sweep / m_channels;
+            const Index c = sweep % m_channels;
+            const float *src = slab + sweep * m_samples;
+            const Index inBrick = b * ((c % b) + b * (t % b));
+            for (Index bs = 0; bs < m_bricksS; ++bs) {
+                const Index run = std::min(b, m_samples - bs * b);
+                std::memcpy(
+                    m_bricks.data() + brickOffset(bs, c / b, t / b) + inBrick,
+                    src + bs * b,
+                    size_t(run) * sizeof(float));
+            }
+        }
+    });
+}
+
+void BrickedVolume::extractBScan(const Index channelIndex, Eigen::MatrixXf &out) const
+{
+    extractBScanRange(channelIndex, 0, m_slices, out);
+}
+
+void BrickedVolume::extractBScanRange(
+    const Index channelIndex, Index firstSlice, Index slicesCount, Eigen::MatrixXf &out) const
+{
+    if (channelIndex < 0 || channelIndex >= m_channels) {
+        throw std::out_of_range("Invalid channel index");
+    }
+    firstSlice = std::clamp<Index>(firstSlice, 0, m_slices);
+    slicesCount = std::clamp<Index>(slicesCount, 0, m_slices - firstSlice);
+    const Index b = m_brickSize;
+    const Index bc = channelIndex / b;
+    const Index lc = channelIndex % b;
+    out.resize(m_samples, slicesCount);
+
+    ParallelScheduler::instance().parallelFor(0, slicesCount, kSweepGrain, [&](const Index first, const Index last) {
+        for (Index i = first; i < last; ++i) {
+            const Index t = firstSlice + i;
+            const Index inBrick = b * (lc + b * (t % b));
+            float *dst = out.col(i).data();
+            for (Index bs = 0; bs < m_bricksS; ++bs) {
+                const Index run = std::min(b, m_samples - bs * b);
+                std::memcpy(
+                    dst + bs * b,
+                    m_bricks.data() + brickOffset(bs, bc, t / b) + inBrick,
+                    size_t(run) * sizeof(float));
+            }
+        }
+    });
+}
+
+void BrickedVolume::extractCScan(const Index depthIndex, Eigen::MatrixXf &out) const
+{
+    if (depthIndex < 0 || depthIndex >= m_samples) {
+        throw std::out_of_range("Invalid depth index");
+    }
+    const Index b = m_brickSize;
+    const Index bs = depthIndex / b;
+    const Index ls = depthIndex % b;
+    out.resize(m_channels, m_slices);
+
+    // 按砖块遍历：同一砖块内的 b * b 个值位于连续的 b^3 个浮点数中
+    ParallelScheduler::instance().parallelFor(0, m_bricksT, 1, [&](const Index firstBrick, const Index lastBrick) {
+        for (Index bt = firstBrick; bt < lastBrick; ++bt) {
+            const Index sliceEnd = std::min(m_slices, (bt + 1) * b);
+            for (Index bc = 0; bc < m_bricksC; ++bc) {
+                const float *brick = m_bricks.data() + brickOffset(bs, bc, bt);
+                const Index channelEnd = std::min(m_channels, (bc + 1) * b);
+                for (Index t = bt * b; t < sliceEnd; ++t) {
+                    for (Index c = bc * b; c < channelEnd; ++c) {
+                        out(c, t) = brick[ls + b * ((c % b) + b * (t % b))];
+                    }
+                }
+            }
+        }
+    });
+}
+
+void BrickedVolume::extractTScan(const Index sliceIndex, Eigen::MatrixXf &out) const
+{
+    if (sliceIndex < 0 || sliceIndex >= m_slices) {
+        throw std::out_of_range("Invalid volume index");
+    }
+    const Index b = m_brickSize;
+    const Index bt = sliceIndex / b;
+    const Index lt = sliceIndex % b;
+    out.resize(m_samples, m_channels);
+
+    ParallelScheduler::instance().parallelFor(0, m_channels, kSweepGrain, [&](const Index first, const Index last) {
+        for (Index c = first; c < last; ++c) {
+            const Index inBrick = b * ((c % b) + b * lt);
+            float *dst = out.col(c).data();
+            for (Index bs = 0; bs < m_bricksS; ++bs) {
+                const Index run = std::min(b, m_samples - bs * b);
+                std::memcpy(
+                    dst + bs * b,
+                    m_bricks.data() + brickOffset(bs, c / b, bt) + inBrick,
+                    size_t(run) * sizeof(float));
+            }
+        }
+    });
+}
@@ -0,0 +1,69 @@
+#ifndef BRICKEDVOLUME_H
+#define BRICKEDVOLUME_H
+
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <Eigen/Dense>
+#include <vector>
+#include "VolumeStorage.h"
+
+// 按 brickSize^3 的小立方体（砖块）重排的电压值数据体。
+// 砖块之间按 (samples, channels, slices) 方向列优先排列，砖块内部同样列优先，
+// 边缘砖块补零到完整尺寸。任一方向的切片只访问与之相交的砖块，
+// 每个砖块只占连续的几页内存，CScan 不再以整个切片为步长跨越全部数据
+class BrickedVolume
+{
+public:
+    using Index = Eigen::Index;
+
+    explicit BrickedVolume(int brickSize = 16);
+
+    // 从列优先的电压值张量构建
+    void build(const Eigen::Tensor<float, 3> &volume);
+
+    // 从原始采样构建，按砖块厚度逐批转换切片
+    void build(const VolumeStorage<int16_t> &storage);
+
+    void clear();
+
+    bool isEmpty() const;
+
+    int brickSize() const;
+
+    Index samplesCount() const;
+    Index channelsCount() const;
+    Index slicesCount() const;
+
+    // 砖块数据占用的字节数
+    Index residentBytes() const;
+
+    // 获取 BScan 切片（通道方向）：(samples, slices)。索引越界时抛出 std::out_of_range，下同
+    void extractBScan(Index channelIndex, Eigen::MatrixXf &out) const;
+
+    // 获取 BScan 中 [firstSlice, firstSlice + slicesCount) 范围内的道，只访问与之相交的砖块，超出范围的部分截去
+    void extractBScanRange(Index channelIndex, Index firstSlice, Index slicesCount, Eigen::MatrixXf &out) const;
+
+    // 获取 CScan 切片（深度方向）：(channels, slices)
+    void extractCScan(Index depthIndex, Eigen::MatrixXf &out) const;
+
+    // 获取 TScan 切片（行进方向）：(samples, channels)
+    void extractTScan(Index sliceIndex, Eigen::MatrixXf &out) const;
+
+private:
+    void allocate(Index samples, Index channels, Index slices);
+
+    // 写入从 firstSlice 开始的 count 个连续切片，slab 为列优先 (samples, channels, count)
+    void fillSlab(const float *slab, Index firstSlice, Index count);
+
+    Index brickOffset(Index brickSample, Index brickChannel, Index brickSlice) const;
+
+    int m_brickSize;
+    Index m_samples = 0;
+    Index m_channels = 0;
+    Index m_slices = 0;
+    Index m_bricksS = 0;
+    Index m_bricksC = 0;
+    Index m_bricksT = 0;
+    std::vector<float> m_bricks;
+};
+
+#endif // BRICKEDVOLUME_H
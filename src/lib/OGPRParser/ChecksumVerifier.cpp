@@ -0,0 +1,203 @@
+#include "ChecksumVerifier.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace {
+// 每次读取与累加的字节数，也是检查取消请求的粒度
+constexpr qint64 hashChunkBytes = 4 * 1024 * 1024;
+} // namespace
+
+// 解析线程与后台线程共享的状态
+struct ChecksumVerifier::Stream {
+    struct Chunk {
+        qint64 offset = 0;
+        QByteArray data;
+    };
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Chunk> queue;
+    bool hashing = false;   // 后台线程正在计算队首取出的数据
+    bool finished = false;  // 不再送入数据
+    std::atomic_bool cancelled{false};
+    bool stopped = false;   // 后台线程已退出
+
+    // 尚未计算完的数据块数
+    size_t outstanding() const {
+        return queue.size() + (hashing ? 1 : 0);
+    }
+};
+
+ChecksumVerifier::~ChecksumVerifier()
+{
+    cancel();
+}
+
+void ChecksumVerifier::begin(const QString &filePath, const qint64 offset, const qint64 length)
+{
+    cancel();
+    auto stream = std::make_shared<Stream>();
+    m_stream = stream;
+    m_future = std::async(std::launch::async, [filePath, offset, length, stream]() {
+        const auto stop = [&stream](QByteArray digest) {
+            std::lock_guard lock(stream->mutex);
+            stream->stopped = true;
+            stream->queue.clear();
+            stream->changed.notify_all();
+            return digest;
+        };
+
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        const qint64 end = offset + length;
+        qint64 position = offset;
+
+        // 空隙由自己的文件句柄补读
+        QFile file(filePath);
+        QByteArray buffer;
+        const auto hashFileUntil = [&](const qint64 until) {
+            if (position >= until) {
+                return true;
+            }
+            if ((!file.isOpen() && !file.open(QIODevice::ReadOnly)) || !file.seek(position)) {
+                qWarning() << "Failed to open file for checksum:" << filePath;
+                return false;
+            }
+            buffer.resize(std::min(hashChunkBytes, until - position));
+            while (position < until) {
+                if (stream->cancelled) {
+                    return false;
+                }
+                const qint64 bytes = file.read(buffer.data(), std::min(hashChunkBytes, until - position));
+                if (bytes <= 0) {
+                    qWarning() << "Failed to read file for checksum:" << filePath;
+                    return false;
+                }
+                hash.addData(QByteArrayView(buffer.constData(), bytes));
+                position += bytes;
+            }
+            return true;
+        };
+
+        for (;;) {
+            Stream::Chunk chunk;
+            {
+                std::unique_lock lock(stream->mutex);
+                stream->changed.wait(lock, [&stream] {
+                    return stream->cancelled || stream->finished || !stream->queue.empty();
+                });
+                if (stream->cancelled) {
+                    break;
+                }
+                if (stream->queue.empty()) {
+                    // 送入完毕，补读剩余部分
+                    lock.unlock();
+                    const bool ok = hashFileUntil(end);
+                    return stop(ok ? hash.result().toHex() : QByteArray());
+                }
+                chunk = std::move(stream->queue.front());
+                stream->queue.pop_front();
+                stream->hashing = true;
+            }
+
+            // 先补读到本块之前的空隙；已经计算过的部分（顺序错乱时）跳过
+            const qint64 chunkEnd = std::min(end, chunk.offset + qint64(chunk.data.size()));
+            bool ok = hashFileUntil(std::min(chunk.offset, end));
+            if (ok && chunkEnd > position) {
+                const char *data = chunk.data.constData() + (position - chunk.offset);
+                hash.addData(QByteArrayView(data, chunkEnd - position));
+                position = chunkEnd;
+            }
+            // 释放引用后再通知，调用方随即可以复用缓冲区
+            chunk.data = QByteArray();
+            {
+                std::lock_guard lock(stream->mutex);
+                stream->hashing = false;
+                stream->changed.notify_all();
+            }
+            if (!ok) {
+                break;
+            }
+        }
+        return stop(QByteArray());
+    });
+}
+
+void ChecksumVerifier::addData(const qint64 offset, const QByteArray &data)
+{
+    if (!m_stream) {
+        return;
+    }
+    std::unique_lock lock(m_stream->mutex);
+    if (m_stream->stopped || m_stream->finished) {
+        return;
+    }
+    m_stream->queue.push_back({offset, data});
+    m_stream->changed.notify_all();
+    m_stream->changed.wait(lock, [this] { return m_stream->stopped || m_stream->outstanding() <= 1; });
+}
+
+void ChecksumVerifier::finish()
+{
+    if (!m_stream) {
+        return;
+    }
+    std::lock_guard lock(m_stream->mutex);
+    m_stream->finished = true;
+    m_stream->changed.notify_all();
+}
+
+void ChecksumVerifier::start(const uchar *data, const qint64 length)
+{
+    cancel();
+    auto stream = std::make_shared<Stream>();
+    m_stream = stream;
+    m_future = std::async(std::launch::async, [data, length, stream]() {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        const char *bytes = reinterpret_cast<const char *>(data);
+        for (qint64 done = 0; done < length; done += hashChunkBytes) {
+            if (stream->cancelled) {
+                return QByteArray();
+            }
+            hash.addData(QByteArrayView(bytes + done, std::min(hashChunkBytes, length - done)));
+        }
+        return hash.result().toHex();
+    });
+    // 映射页一次给出，不再送入数据
+    finish();
+}
+
+bool ChecksumVerifier::isStarted() const
+{
+    return m_future.valid();
+}
+
+bool ChecksumVerifier::isFinished() const
+{
+    return m_future.valid()
+           && m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+QByteArray ChecksumVerifier::result() const
+{
+    return m_future.valid() ? m_future.get() : QByteArray();
+}
+
+void ChecksumVerifier::cancel()
+{
+    if (m_stream) {
+        std::lock_guard lock(m_stream->mutex);
+        m_stream->cancelled = true;
+        m_stream->changed.notify_all();
+    }
+    if (m_future.valid()) {
+        m_future.wait();
+    }
+    m_future = {};
+    m_stream.reset();
+}
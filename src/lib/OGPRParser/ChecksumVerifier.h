@@ -0,0 +1,54 @@
+#ifndef CHECKSUMVERIFIER_H
+#define CHECKSUMVERIFIER_H
+
+#include <QByteArray>
+#include <QString>
+#include <future>
+#include <memory>
+
+// 在后台线程中增量计算 MD5，与数据块解析过程重叠。
+// 读文件时由解析过程把已读入的数据块按文件顺序送入，不再单独读一遍文件；
+// 送入的数据之间若有空隙（如未解析的数据块），后台线程用自己的文件句柄只补读空隙。
+// 内存映射时直接对映射页计算
+class ChecksumVerifier
+{
+public:
+    ChecksumVerifier() = default;
+    ~ChecksumVerifier();
+
+    ChecksumVerifier(const ChecksumVerifier &) = delete;
+    ChecksumVerifier &operator=(const ChecksumVerifier &) = delete;
+
+    // 开始计算文件中 [offset, offset + length) 的 MD5，数据随后通过 addData 送入
+    void begin(const QString &filePath, qint64 offset, qint64 length);
+
+    // 送入文件中从 offset 开始的数据，未开始或 finish 之后忽略，可在任意线程调用。
+    // data 被引用而不拷贝：返回时此前送入的数据均已计算完毕并释放，只有本次的仍在使用，
+    // 调用方交替使用两个缓冲区即可在计算的同时读入下一块
+    void addData(qint64 offset, const QByteArray &data);
+
+    // 数据送入完毕，剩余未送入的部分由后台线程读取
+    void finish();
+
+    // 计算内存 [data, data + length) 的 MD5，调用方保证内存在计算期间有效
+    void start(const uchar *data, qint64 length);
+
+    bool isStarted() const;
+
+    // 计算是否已结束（不阻塞）
+    bool isFinished() const;
+
+    // 等待计算完成，返回小写十六进制摘要；读取失败或被取消时返回空
+    QByteArray result() const;
+
+    // 取消并等待后台线程退出
+    void cancel();
+
+private:
+    struct Stream;
+
+    std::shared_future<QByteArray> m_future;
+    std::shared_ptr<Stream> m_stream;
+};
+
+#endif // CHECKSUMVERIFIER_H
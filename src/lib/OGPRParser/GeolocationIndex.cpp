@@ -0,0 +1,292 @@
+#include "GeolocationIndex.h"
+#include "OGPRParser.h"
+#include "ParallelScheduler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 计算格子编号时每个并行区间的点数
+constexpr std::int64_t kPointGrain = 64 * 1024;
+// 逐圈搜索访问的格子数超过点数的这一倍数时改为逐点扫描，稀疏测线的大包围盒下空格子很多
+constexpr qint64 kRingCellsPerPoint = 2;
+
+// 奇偶规则判断点是否位于多边形内
+bool containsPoint(const QVector<QPointF> &polygon, const double x, const double y)
+{
+    bool inside = false;
+    const qsizetype n = polygon.size();
+    for (qsizetype i = 0, j = n - 1; i < n; j = i++) {
+        const double xi = polygon[i].x();
+        const double yi = polygon[i].y();
+        const double xj = polygon[j].x();
+        const double yj = polygon[j].y();
+        if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+} // namespace
+
+void GeolocationIndex::build(const SampleGeolocations &geolocations, const int pointsPerCell)
+{
+    clear();
+    const qint64 count = geolocations.shallow.x.size();
+    if (count == 0 || geolocations.channelsCount <= 0) {
+        return;
+    }
+    const double *xs = geolocations.shallow.x.constData();
+    const double *ys = geolocations.shallow.y.constData();
+
+    // 包围盒，跳过无效坐标
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = minX;
+    double maxX = -minX;
+    double maxY = -minX;
+    qint64 valid = 0;
+    for (qint64 i = 0; i < count; ++i) {
+        if (!std::isfinite(xs[i]) || !std::isfinite(ys[i])) {
+            continue;
+        }
+        minX = std::min(minX, xs[i]);
+        maxX = std::max(maxX, xs[i]);
+        minY = std::min(minY, ys[i]);
+        maxY = std::max(maxY, ys[i]);
+        ++valid;
+    }
+    if (valid == 0) {
+        return;
+    }
+
+    // 格子总数约为 valid / pointsPerCell，按包围盒长宽比分配到两个方向
+    const double width = maxX - minX;
+    const double height = maxY - minY;
+    const double cells = std::max(1.0, double(valid) / std::max(1, pointsPerCell));
+    if (width > 0.0 && height > 0.0) {
+        m_cellsX = std::clamp<qint64>(std::llround(std::sqrt(cells * width / height)), 1, qint64(cells));
+        m_cellsY = std::max<qint64>(1, std::llround(cells / m_cellsX));
+    } else if (width > 0.0) {
+        m_cellsX = qint64(cells);
+        m_cellsY = 1;
+    } else if (height > 0.0) {
+        m_cellsX = 1;
+        m_cellsY = qint64(cells);
+    } else {
+        m_cellsX = m_cellsY = 1;
+    }
+    m_channelsCount = geolocations.channelsCount;
+    m_minX = minX;
+    m_minY = minY;
+    m_cellWidth = width > 0.0 ? width / m_cellsX : 1.0;
+    m_cellHeight = height > 0.0 ? height / m_cellsY : 1.0;
+
+    // 计数排序：先统计每格点数，再按前缀和写入
+    std::vector<qint64> cellOf(count, -1);
+    m_cellStart.assign(m_cellsX * m_cellsY + 1, 0);
+    ParallelScheduler::instance().parallelFor(0, count, kPointGrain, [&](const qint64 first, const qint64 last) {
+        for (qint64 i = first; i < last; ++i) {
+            if (std::isfinite(xs[i]) && std::isfinite(ys[i])) {
+                cellOf[i] = cellY(ys[i]) * m_cellsX + cellX(xs[i]);
+            }
+        }
+    });
+    for (qint64 i = 0; i < count; ++i) {
+        if (cellOf[i] >= 0) {
+            ++m_cellStart[cellOf[i] + 1];
+        }
+    }
+    for (size_t cell = 1; cell < m_cellStart.size(); ++cell) {
+        m_cellStart[cell] += m_cellStart[cell - 1];
+    }
+
+    m_points.resize(valid);
+    m_x.resize(valid);
+    m_y.resize(valid);
+    std::vector<qint64> cursor(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (qint64 i = 0; i < count; ++i) {
+        if (cellOf[i] < 0) {
+            continue;
+        }
+        const qint64 slot = cursor[cellOf[i]]++;
+        m_points[slot] = i;
+        m_x[slot] = xs[i];
+        m_y[slot] = ys[i];
+    }
+}
+
+void GeolocationIndex::clear()
+{
+    m_channelsCount = 0;
+    m_cellsX = m_cellsY = 0;
+    m_cellStart.clear();
+    m_points.clear();
+    m_x.clear();
+    m_y.clear();
+}
+
+bool GeolocationIndex::isEmpty() const
+{
+    return m_points.empty();
+}
+
+GeolocationIndex::Hit GeolocationIndex::nearest(const double x, const double y) const
+{
+    Hit hit;
+    // 非有限坐标无法换算格子编号
+    if (isEmpty() || !std::isfinite(x) || !std::isfinite(y)) {
+        return hit;
+    }
+
+    const qint64 cx = cellX(x);
+    const qint64 cy = cellY(y);
+    double best = std::numeric_limits<double>::infinity();
+    qint64 bestPoint = -1;
+
+    const auto visitPoints = [&](const qint64 first, const qint64 last) {
+        for (qint64 k = first; k < last; ++k) {
+            const double dx = m_x[k] - x;
+            const double dy = m_y[k] - y;
+            const double d = dx * dx + dy * dy;
+            if (d < best) {
+                best = d;
+                bestPoint = m_points[k];
+            }
+        }
+    };
+
+    const qint64 maxRingCells = kRingCellsPerPoint * qint64(m_points.size());
+    qint64 ringCells = 0;
+    const auto visitCell = [&](const qint64 gx, const qint64 gy) {
+        ++ringCells;
+        if (gx < 0 || gx >= m_cellsX || gy < 0 || gy >= m_cellsY) {
+            return;
+        }
+        const qint64 cell = gy * m_cellsX + gx;
+        visitPoints(m_cellStart[cell], m_cellStart[cell + 1]);
+    };
+
+    // 以查询点所在格为中心逐圈向外搜索，直到圈外格子不可能更近
+    for (qint64 r = 0;; ++r) {
+        if (ringCells > maxRingCells) {
+            // 空格子太多，逐点扫描全部点更快
+            visitPoints(0, qint64(m_points.size()));
+            break;
+        }
+        const qint64 x0 = cx - r;
+        const qint64 x1 = cx + r;
+        const qint64 y0 = cy - r;
+        const qint64 y1 = cy + r;
+        for (qint64 gx = x0; gx <= x1; ++gx) {
+            visitCell(gx, y0);
+            if (y1 != y0) {
+                visitCell(gx, y1);
+            }
+        }
+        for (qint64 gy = y0 + 1; gy < y1; ++gy) {
+            visitCell(x0, gy);
+            visitCell(x1, gy);
+        }
+
+        if (x0 <= 0 && y0 <= 0 && x1 >= m_cellsX - 1 && y1 >= m_cellsY - 1) {
+            break;
+        }
+        // 未访问区域由四个矩形组成：左、右两侧的整列与上下两侧的剩余部分
+        const qint64 bx0 = std::max<qint64>(x0, 0);
+        const qint64 bx1 = std::min(x1, m_cellsX - 1);
+        double bound = std::numeric_limits<double>::infinity();
+        if (x0 > 0) {
+            bound = std::min(bound, distanceToCells(x, y, 0, x0 - 1, 0, m_cellsY - 1));
+        }
+        if (x1 < m_cellsX - 1) {
+            bound = std::min(bound, distanceToCells(x, y, x1 + 1, m_cellsX - 1, 0, m_cellsY - 1));
+        }
+        if (y0 > 0) {
+            bound = std::min(bound, distanceToCells(x, y, bx0, bx1, 0, y0 - 1));
+        }
+        if (y1 < m_cellsY - 1) {
+            bound = std::min(bound, distanceToCells(x, y, bx0, bx1, y1 + 1, m_cellsY - 1));
+        }
+        if (best <= bound) {
+            break;
+        }
+    }
+
+    hit.slice = bestPoint / m_channelsCount;
+    hit.channel = bestPoint % m_channelsCount;
+    hit.distance = std::sqrt(best);
+    return hit;
+}
+
+QVector<qint64> GeolocationIndex::slicesInPolygon(const QVector<QPointF> &polygon) const
+{
+    QVector<qint64> result;
+    if (isEmpty() || polygon.size() < 3) {
+        return result;
+    }
+
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = minX;
+    double maxX = -minX;
+    double maxY = -minX;
+    for (const QPointF &point : polygon) {
+        minX = std::min(minX, point.x());
+        maxX = std::max(maxX, point.x());
+        minY = std::min(minY, point.y());
+        maxY = std::max(maxY, point.y());
+    }
+    if (maxX < m_minX || maxY < m_minY
+        || minX > m_minX + m_cellsX * m_cellWidth || minY > m_minY + m_cellsY * m_cellHeight) {
+        return result;
+    }
+
+    // 只检查与多边形包围盒相交的格子
+    std::vector<qint64> slices;
+    for (qint64 gy = cellY(minY); gy <= cellY(maxY); ++gy) {
+        for (qint64 gx = cellX(minX); gx <= cellX(maxX); ++gx) {
+            const qint64 cell = gy * m_cellsX + gx;
+            for (qint64 k = m_cellStart[cell]; k < m_cellStart[cell + 1]; ++k) {
+                // 格内点号升序，同一切片的通道相邻，先跳过已命中的切片
+                const qint64 slice = m_points[k] / m_channelsCount;
+                if ((slices.empty() || slices.back() != slice)
+                    && containsPoint(polygon, m_x[k], m_y[k])) {
+                    slices.push_back(slice);
+                }
+            }
+        }
+    }
+    std::sort(slices.begin(), slices.end());
+    slices.erase(std::unique(slices.begin(), slices.end()), slices.end());
+
+    result.reserve(qsizetype(slices.size()));
+    for (const qint64 slice : slices) {
+        result.append(slice);
+    }
+    return result;
+}
+
+qint64 GeolocationIndex::cellX(const double x) const
+{
+    const double cell = std::floor((x - m_minX) / m_cellWidth);
+    return qint64(std::clamp(cell, 0.0, double(m_cellsX - 1)));
+}
+
+qint64 GeolocationIndex::cellY(const double y) const
+{
+    const double cell = std::floor((y - m_minY) / m_cellHeight);
+    return qint64(std::clamp(cell, 0.0, double(m_cellsY - 1)));
+}
+
+double GeolocationIndex::distanceToCells(
+    const double x, const double y, const qint64 x0, const qint64 x1, const qint64 y0, const qint64 y1) const
+{
+    const double left = m_minX + x0 * m_cellWidth;
+    const double right = m_minX + (x1 + 1) * m_cellWidth;
+    const double bottom = m_minY + y0 * m_cellHeight;
+    const double top = m_minY + (y1 + 1) * m_cellHeight;
+    const double dx = std::max({left - x, 0.0, x - right});
+    const double dy = std::max({bottom - y, 0.0, y - top});
+    return dx * dx + dy * dy;
+}
@@ -0,0 +1,63 @@
+#ifndef GEOLOCATIONINDEX_H
+#define GEOLOCATIONINDEX_H
+
+#include <QPointF>
+#include <QVector>
+#include <vector>
+
+struct SampleGeolocations;
+
+// 采样平面位置 (x, y) 上的均匀网格索引。
+// 网格按点数自适应划分（平均每格 pointsPerCell 个点），格内点号以 CSR 形式连续存储：
+// m_cellStart[cell] .. m_cellStart[cell + 1] 为该格在 m_points 中的区间。
+// 距离按坐标系内的欧氏距离计算，经纬度坐标下仅用于近邻查找，不代表实际米数
+class GeolocationIndex
+{
+public:
+    struct Hit {
+        qint64 slice = -1;
+        qint64 channel = -1;
+        double distance = 0.0;
+
+        bool isValid() const {
+            return slice >= 0;
+        }
+    };
+
+    GeolocationIndex() = default;
+
+    // 以最小深度坐标块建立索引，NaN 坐标被忽略
+    void build(const SampleGeolocations &geolocations, int pointsPerCell = 4);
+
+    void clear();
+
+    bool isEmpty() const;
+
+    // 离 (x, y) 最近的切片与通道，索引为空时返回无效结果
+    Hit nearest(double x, double y) const;
+
+    // 至少有一个通道位于多边形内（奇偶规则）的切片，升序且不重复
+    QVector<qint64> slicesInPolygon(const QVector<QPointF> &polygon) const;
+
+private:
+    qint64 cellX(double x) const;
+    qint64 cellY(double y) const;
+
+    // 点到网格中 [x0, x1] x [y0, y1] 格子区域的最近距离的平方
+    double distanceToCells(double x, double y, qint64 x0, qint64 x1, qint64 y0, qint64 y1) const;
+
+    qint64 m_channelsCount = 0;
+    qint64 m_cellsX = 0;
+    qint64 m_cellsY = 0;
+    double m_minX = 0.0;
+    double m_minY = 0.0;
+    double m_cellWidth = 1.0;
+    double m_cellHeight = 1.0;
+    std::vector<qint64> m_cellStart;
+    std::vector<qint64> m_points; // 点号：slice * channelsCount + channel
+    // 与 m_points 同序的坐标副本，查询时连续访问
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+};
+
+#endif // GEOLOCATIONINDEX_H
@@ -0,0 +1,241 @@
+#include "OGPRAsyncLoader.h"
+#include "SampleConversion.h"
+#include <QMetaObject>
+#include <algorithm>
+
+OGPRAsyncLoader::OGPRAsyncLoader(QObject *parent)
+    : QObject(parent)
+    , m_parser(std::make_unique<OGPRParser>())
+{}
+
+OGPRAsyncLoader::~OGPRAsyncLoader()
+{
+    stopWorker();
+}
+
+bool OGPRAsyncLoader::load(const QString &filePath)
+{
+    const bool wasLoading = m_loading;
+    stopWorker();
+    ++m_generation;
+    m_loading = false;
+    m_loadedSlices = 0;
+    m_published = {};
+    m_totalSlices = 0;
+    if (wasLoading) {
+        emit canceled();
+    }
+
+    // 先读取头部，尺寸在加载开始前就已知
+    OpenGPRHeader header;
+    if (!OGPRParser::probeOGPRFile(filePath, header)) {
+        if (wasLoading) {
+            emit loadingChanged();
+        }
+        emit progressChanged();
+        return false;
+    }
+    m_header = header;
+    m_totalSlices = int(header.slicesCount);
+    if (m_filePath != filePath) {
+        m_filePath = filePath;
+        emit filePathChanged();
+    }
+
+    // 工作线程中只做取消检查与事件投递，状态修改都在本对象线程中进行
+    const quint64 generation = m_generation;
+    m_loadingParser = std::make_unique<OGPRParser>();
+    OGPRParser *parser = m_loadingParser.get();
+    OGPRLoadOptions options = m_options;
+    options.sliceProgress = [this, parser, generation](
+                                const int volumeIndex, const qint64 firstSlice, const qint64 sliceCount) {
+        if (m_cancelRequested.load()) {
+            return false;
+        }
+        // 只发布第一个雷达数据块（默认的当前数据块）。回调在解析线程中，可以读取解析器；
+        // 切片在投递之前已写完，本对象线程收到事件后读取是安全的
+        if (volumeIndex == 0) {
+            const RadarVolume &radarVolume = parser->getHeader().radarVolumes.at(0);
+            PublishedVolume volume;
+            if (radarVolume.hasNativeSamples()) {
+                volume.samples = radarVolume.samples.data();
+                volume.calibration = radarVolume.samples.calibration();
+            } else {
+                volume.voltages = radarVolume.data.data();
+            }
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation, firstSlice, sliceCount, volume]() {
+                    publishSlices(generation, int(firstSlice), int(sliceCount), volume);
+                },
+                Qt::QueuedConnection);
+        }
+        return true;
+    };
+
+    m_cancelRequested = false;
+    m_worker = QThread::create([this, parser, filePath, options, generation]() {
+        const bool success = parser->parseOGPRFile(filePath, options);
+        QMetaObject::invokeMethod(
+            this,
+            [this, generation, success]() { onWorkerFinished(generation, success); },
+            Qt::QueuedConnection);
+    });
+    m_worker->start();
+
+    m_loading = true;
+    emit loadingChanged();
+    emit progressChanged();
+    return true;
+}
+
+void OGPRAsyncLoader::cancel()
+{
+    if (m_loading) {
+        m_cancelRequested = true;
+    }
+}
+
+void OGPRAsyncLoader::setLoadOptions(const OGPRLoadOptions &options)
+{
+    m_options = options;
+    m_options.sliceProgress = nullptr;
+}
+
+const OGPRLoadOptions &OGPRAsyncLoader::loadOptions() const
+{
+    return m_options;
+}
+
+bool OGPRAsyncLoader::isLoading() const
+{
+    return m_loading;
+}
+
+QString OGPRAsyncLoader::filePath() const
+{
+    return m_filePath;
+}
+
+int OGPRAsyncLoader::loadedSlices() const
+{
+    return m_loadedSlices;
+}
+
+int OGPRAsyncLoader::totalSlices() const
+{
+    return m_totalSlices;
+}
+
+double OGPRAsyncLoader::progress() const
+{
+    return m_totalSlices > 0 ? double(m_loadedSlices) / m_totalSlices : 0.0;
+}
+
+const OpenGPRHeader &OGPRAsyncLoader::header() const
+{
+    return m_header;
+}
+
+bool OGPRAsyncLoader::copyBScan(const int channelIndex, Eigen::MatrixXf &out) const
+{
+    if (m_loadedSlices <= 0 || channelIndex < 0 || channelIndex >= m_header.channelsCount) {
+        return false;
+    }
+    if (!m_loading) {
+        m_parser->copyBScan(channelIndex, out, m_loadedSlices);
+        return out.size() > 0;
+    }
+    // 只读取已发布的切片，工作线程此时只写入之后的切片
+    out.resize(m_header.samplesCount, m_loadedSlices);
+    for (int slice = 0; slice < m_loadedSlices; ++slice) {
+        copyPublishedSweep(slice, channelIndex, out.col(slice).data());
+    }
+    return out.size() > 0;
+}
+
+bool OGPRAsyncLoader::copyTScan(const int sliceIndex, Eigen::MatrixXf &out) const
+{
+    if (sliceIndex < 0 || sliceIndex >= m_loadedSlices) {
+        return false;
+    }
+    if (!m_loading) {
+        m_parser->copyTScan(sliceIndex, out);
+        return out.size() > 0;
+    }
+    out.resize(m_header.samplesCount, m_header.channelsCount);
+    for (int channel = 0; channel < m_header.channelsCount; ++channel) {
+        copyPublishedSweep(sliceIndex, channel, out.col(channel).data());
+    }
+    return out.size() > 0;
+}
+
+void OGPRAsyncLoader::copyPublishedSweep(const int slice, const int channel, float *out) const
+{
+    const qint64 samples = m_header.samplesCount;
+    const qint64 offset = (qint64(slice) * m_header.channelsCount + channel) * samples;
+    if (m_published.samples) {
+        convertSamplesToVoltage(m_published.samples + offset, out, samples, m_published.calibration);
+    } else {
+        std::copy_n(m_published.voltages + offset, samples, out);
+    }
+}
+
+OGPRParser &OGPRAsyncLoader::parser()
+{
+    return *m_parser;
+}
+
+const OGPRParser &OGPRAsyncLoader::parser() const
+{
+    return *m_parser;
+}
+
+void OGPRAsyncLoader::stopWorker()
+{
+    if (!m_worker) {
+        return;
+    }
+    m_cancelRequested = true;
+    m_worker->wait();
+    delete m_worker;
+    m_worker = nullptr;
+}
+
+void OGPRAsyncLoader::publishSlices(
+    const quint64 generation, const int firstSlice, const int sliceCount, const PublishedVolume &volume)
+{
+    if (generation != m_generation || sliceCount <= 0) {
+        return;
+    }
+    m_published = volume;
+    // 同一数据块的切片按顺序解码，已加载部分始终是前缀
+    m_loadedSlices = std::max(m_loadedSlices, firstSlice + sliceCount);
+    emit progressChanged();
+    emit slicesAvailable(firstSlice, firstSlice + sliceCount - 1);
+}
+
+void OGPRAsyncLoader::onWorkerFinished(const quint64 generation, const bool success)
+{
+    if (generation != m_generation) {
+        return;
+    }
+    const bool wasCanceled = m_cancelRequested.load() && !success;
+    stopWorker();
+    // 成功时换入新的解析器，失败或取消时保留上一次的结果
+    if (success) {
+        m_parser = std::move(m_loadingParser);
+    } else {
+        m_loadedSlices = 0;
+        emit progressChanged();
+    }
+    m_loadingParser.reset();
+    m_published = {};
+    m_loading = false;
+    emit loadingChanged();
+    if (wasCanceled) {
+        emit canceled();
+    } else {
+        emit finished(success);
+    }
+}
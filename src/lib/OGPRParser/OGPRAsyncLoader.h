@@ -0,0 +1,103 @@
+#ifndef OGPRASYNCLOADER_H
+#define OGPRASYNCLOADER_H
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include "OGPRParser.h"
+
+// 在工作线程中加载 .ogpr 文件。切片按采集顺序解码，每解码完一段就通过 slicesAvailable 发布，
+// 不必等整个数据体转换完成即可显示已加载部分（如第一个 BScan 的前若干列）。
+// 所有信号与属性变化都在本对象所在线程（通常是 GUI 线程）中发出，QML 可直接绑定。
+// 工作线程解析到自己的 OGPRParser，成功后才替换 parser()；加载过程中只通过工作线程发布的
+// 数据位置读取已发布的切片，不访问正在被修改的解析器
+class OGPRAsyncLoader : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+    Q_PROPERTY(QString filePath READ filePath NOTIFY filePathChanged)
+    Q_PROPERTY(int loadedSlices READ loadedSlices NOTIFY progressChanged)
+    Q_PROPERTY(int totalSlices READ totalSlices NOTIFY progressChanged)
+    Q_PROPERTY(double progress READ progress NOTIFY progressChanged)
+
+public:
+    explicit OGPRAsyncLoader(QObject *parent = nullptr);
+    ~OGPRAsyncLoader() override;
+
+    // 开始加载：先同步读取 JSON 头得到尺寸，再在工作线程中解码负载；
+    // 正在加载时会先取消上一次加载。头部无效时返回 false，不发出 finished
+    Q_INVOKABLE bool load(const QString &filePath);
+
+    // 取消加载，在下一段切片解码完成后生效，随后发出 canceled
+    Q_INVOKABLE void cancel();
+
+    // 加载选项，sliceProgress 由加载器接管
+    void setLoadOptions(const OGPRLoadOptions &options);
+    const OGPRLoadOptions &loadOptions() const;
+
+    bool isLoading() const;
+    QString filePath() const;
+    int loadedSlices() const;
+    int totalSlices() const;
+    double progress() const;
+
+    // 文件头，load 返回 true 后即可用
+    const OpenGPRHeader &header() const;
+
+    // 已加载部分的切片，加载过程中也可调用。
+    // BScan 只包含前 loadedSlices 个切片；TScan 要求该切片已加载；未加载时返回 false
+    bool copyBScan(int channelIndex, Eigen::MatrixXf &out) const;
+    bool copyTScan(int sliceIndex, Eigen::MatrixXf &out) const;
+
+    // 最近一次加载成功的解析器，加载过程中保持不变，finished(true) 时替换为新文件
+    OGPRParser &parser();
+    const OGPRParser &parser() const;
+
+signals:
+    void loadingChanged();
+    void filePathChanged();
+    void progressChanged();
+    // 切片 [firstSlice, lastSlice] 已解码，可以显示
+    void slicesAvailable(int firstSlice, int lastSlice);
+    void finished(bool success);
+    void canceled();
+
+private:
+    // 工作线程发布切片时给出的第一个数据块的存储位置，电压值或原始采样二选一。
+    // 数据块在解析开始时一次分配，之后不再移动
+    struct PublishedVolume {
+        const float *voltages = nullptr;
+        const int16_t *samples = nullptr;
+        VoltageCalibration calibration;
+    };
+
+    // 等待工作线程退出，不发出信号
+    void stopWorker();
+
+    // 在本对象线程中处理工作线程发布的切片
+    void publishSlices(quint64 generation, int firstSlice, int sliceCount, const PublishedVolume &volume);
+
+    // 已发布的第 slice 个切片中通道 channel 的一道
+    void copyPublishedSweep(int slice, int channel, float *out) const;
+
+    void onWorkerFinished(quint64 generation, bool success);
+
+    std::unique_ptr<OGPRParser> m_parser;
+    // 正在加载的解析器，只由工作线程修改
+    std::unique_ptr<OGPRParser> m_loadingParser;
+    PublishedVolume m_published;
+    OGPRLoadOptions m_options;
+    OpenGPRHeader m_header;
+    QString m_filePath;
+    QThread *m_worker = nullptr;
+    std::atomic_bool m_cancelRequested{false};
+    // 区分不同次加载，丢弃已取消加载残留的排队事件
+    quint64 m_generation = 0;
+    bool m_loading = false;
+    int m_loadedSlices = 0;
+    int m_totalSlices = 0;
+};
+
+#endif // OGPRASYNCLOADER_H
@@ -1,24 +1,204 @@
 #include "OGPRParser.h"
+#include "ParallelScheduler.h"
+#include "SampleConversion.h"
+#include "TraceCodec.h"
 #include <QJsonArray>
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 // 构造函数
 OGPRParser::OGPRParser()
     : m_ogprFile({})
 {}
 OGPRParser::~OGPRParser()
 {
+    releaseMapping();
     qDebug() << "~OGPRParser";
 }
 
+void OGPRParser::releaseMapping()
+{
+    // 后台校验可能仍在读取映射页
+    m_checksumVerifier.cancel();
+    for (RadarVolume &volume : m_ogprFile.header.radarVolumes) {
+        if (volume.isMapped()) {
+            volume.samples.clear();
+        }
+    }
+    if (m_mappedFile && m_mappedData) {
+        m_mappedFile->unmap(m_mappedData);
+    }
+    m_mappedData = nullptr;
+    m_mappedFile.reset();
+}
+
 // 解析 .ogpr 文件
-bool OGPRParser::parseOGPRFile(const QString &filePath)
+bool OGPRParser::parseOGPRFile(const QString &filePath, const OGPRLoadOptions &options)
 {
-    QFile file(filePath);
+    releaseBrickedLayout();
+    releaseOverviewPyramid();
+    releaseMapping();
+    m_checksumStatus = ChecksumStatus::NotVerified;
+    m_activeVolume = 0;
+    // 新文件可能没有地理定位块，不能保留上一个文件的坐标与索引
+    m_ogprFile.header.sampleGeolocations = SampleGeolocations();
+    m_geolocationIndex.clear();
+
+    auto filePtr = std::make_unique<QFile>(filePath);
+    QFile &file = *filePtr;
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open file:" << filePath;
         return false;
     }
 
+    // Step 1 & 2: Read Preamble and JSON Header
+    QByteArray jsonHeader;
+    if (!readHeader(file, m_ogprFile, &jsonHeader)) {
+        return false;
+    }
+
+    // 内存映射模式：一次映射整个文件，数据块直接引用映射页
+    if (options.memoryMapped) {
+        m_mappedData = file.map(0, file.size());
+        if (!m_mappedData) {
+            qWarning() << "Failed to map file:" << filePath << file.errorString();
+            return false;
+        }
+        // 映射需要在文件对象存活期间保持有效
+        m_mappedFile = std::move(filePtr);
+    }
+
+    // 在后台线程中计算前导与结尾之间全部字节（JSON 头与数据块）的 MD5，与数据块解析重叠
+    auto checksumMode = options.checksumMode;
+    if (checksumMode == OGPRLoadOptions::ChecksumMode::Auto) {
+        checksumMode = m_mappedData ? OGPRLoadOptions::ChecksumMode::Deferred
+                                    : OGPRLoadOptions::ChecksumMode::Verify;
+    }
+    if (checksumMode != OGPRLoadOptions::ChecksumMode::Skip && file.size() >= 47 + 33) {
+        m_checksumPayloadBytes = file.size() - 47 - 33;
+        if (!m_mappedData) {
+            // 数据块读入时依次送入，不再单独读一遍文件
+            m_checksumVerifier.begin(filePath, 47, m_checksumPayloadBytes);
+            m_checksumVerifier.addData(47, jsonHeader);
+        } else if (checksumMode == OGPRLoadOptions::ChecksumMode::Verify) {
+            m_checksumVerifier.start(m_mappedData + 47, m_checksumPayloadBytes);
+        }
+        // 映射模式的 Deferred 不在加载时换入整个文件，第一次查询时才开始
+        m_checksumStatus = ChecksumStatus::Pending;
+    }
+    // Step 3: Read Data Blocks
+    // 每个雷达数据块各自解码到一个 RadarVolume；地理定位块按顺序在同一任务中解析
+    const qint64 fileSize = file.size();
+    QVector<const DataBlockDescriptor *> volumeBlocks;
+    QVector<const DataBlockDescriptor *> geolocationBlocks;
+    qint64 epiloguePos = file.pos();
+    for (const DataBlockDescriptor &block : std::as_const(m_ogprFile.header.dataBlocks)) {
+        if (block.byteOffset < 0 || block.byteSize < 0
+            || block.byteOffset > fileSize - block.byteSize) {
+            qWarning() << "Failed to read data block:" << block.name;
+            continue;
+        }
+        if (block.type == "Radar Volume") {
+            volumeBlocks.append(&block);
+        } else if (block.type == "Sample Geolocations") {
+            geolocationBlocks.append(&block);
+        }
+        // 结尾紧跟在最后一个数据块之后
+        epiloguePos = block.byteOffset + block.byteSize;
+    }
+
+    auto &volumes = m_ogprFile.header.radarVolumes;
+    volumes = QVector<RadarVolume>(volumeBlocks.size());
+    RadarVolume *volumeSlots = volumes.data();
+
+    // 互相独立的数据块并发解码，每个任务使用自己的文件句柄（或映射页），无共享的读写位置。
+    // 任务按第一个数据块在文件中的位置排序
+    std::vector<std::pair<qint64, std::function<bool(QFile &)>>> tasks;
+    for (qsizetype i = 0; i < volumeBlocks.size(); ++i) {
+        const DataBlockDescriptor *block = volumeBlocks.at(i);
+        RadarVolume *volume = volumeSlots + i;
+        tasks.emplace_back(block->byteOffset, [this, block, volume, i, &options](QFile &taskFile) {
+            if (const auto ret = parseRadarVolume(taskFile, *block, options, int(i), *volume); !ret) {
+                qWarning() << "Failed to parse Radar Volume";
+                return false;
+            }
+            return true;
+        });
+    }
+    if (!geolocationBlocks.isEmpty()) {
+        const qint64 firstOffset = geolocationBlocks.front()->byteOffset;
+        tasks.emplace_back(firstOffset, [this, &geolocationBlocks, &options](QFile &taskFile) {
+            for (const DataBlockDescriptor *block : std::as_const(geolocationBlocks)) {
+                if (const auto ret = parseSampleGeolocations(taskFile, *block, options); !ret) {
+                    qWarning() << "Failed to parse Sample Geolocations";
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    std::stable_sort(tasks.begin(), tasks.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    bool blocksOk = true;
+    if (tasks.size() == 1) {
+        // 只有一个任务时按文件顺序读入，读入的数据直接送去计算 MD5
+        blocksOk = tasks.front().second(file);
+    } else if (tasks.size() > 1) {
+        // 并发解码时各任务的读入顺序不定，不再送入数据，剩余部分由校验线程自己读取，与解码同时进行。
+        // 每个任务占一个调度器线程，任务内的转换内核在该线程中串行执行
+        m_checksumVerifier.finish();
+        std::atomic_bool tasksOk{true};
+        ParallelScheduler::instance().parallelFor(
+            0, std::int64_t(tasks.size()), 1, [&](const std::int64_t first, const std::int64_t last) {
+                for (std::int64_t i = first; i < last; ++i) {
+                    QFile taskFile(filePath);
+                    if (!taskFile.open(QIODevice::ReadOnly)) {
+                        qWarning() << "Failed to open file:" << filePath;
+                        tasksOk = false;
+                    } else if (!tasks[size_t(i)].second(taskFile)) {
+                        tasksOk = false;
+                    }
+                }
+            });
+        blocksOk = tasksOk;
+    }
+    if (!blocksOk) {
+        m_checksumVerifier.cancel();
+        m_checksumStatus = ChecksumStatus::NotVerified;
+        return false;
+    }
+    // 未解析的数据块与块间空隙由校验线程补读
+    m_checksumVerifier.finish();
+    file.seek(epiloguePos);
+
+    // Step 4: Read Epilogue
+    const QByteArray epilogue = file.read(33); // Fixed size epilogue
+    if (epilogue.size() < 33) {
+        qWarning() << "Invalid file format: Epilogue too short";
+        return false;
+    }
+
+    // Verify MD5 checksum
+    if (const QByteArray epilogueMd5 = epilogue.mid(1, 32); epilogueMd5 != m_ogprFile.md5) {
+        qWarning() << "MD5 checksum mismatch";
+        return false;
+    }
+
+    // 按解析后的模式判断，Auto 在拷贝模式下同样等待校验结果
+    if (checksumMode == OGPRLoadOptions::ChecksumMode::Verify
+        && checksumStatus(true) != ChecksumStatus::Valid) {
+        qWarning() << "MD5 checksum mismatch: payload is corrupt";
+        return false;
+    }
+    return true;
+}
+
+// 读取前导与 JSON 头，填充版本、主描述符与数据块描述符，文件位置停在 JSON 头之后
+bool OGPRParser::readHeader(QFile &file, OpenGPRFile &ogprFile, QByteArray *jsonHeaderBytes)
+{
     // Step 1: Read Preamble
     const QByteArray preamble = file.read(47); // Fixed size preamble
     if (preamble.size() < 47) {
@@ -27,14 +207,14 @@ bool OGPRParser::parseOGPRFile(const QString &filePath)
     }
 
     // Extract Magic Number
-    m_ogprFile.magicNumber = preamble.left(5);
-    if (m_ogprFile.magicNumber != "ogpr\n") {
+    ogprFile.magicNumber = preamble.left(5);
+    if (ogprFile.magicNumber != "ogpr\n") {
         qWarning() << "Invalid file format: Magic number mismatch";
         return false;
     }
 
     // Extract MD5 and JSON Header Size
-    m_ogprFile.md5 = preamble.mid(5, 32); // a fixed size text line (32 bytes + LF)
+    ogprFile.md5 = preamble.mid(5, 32); // a fixed size text line (32 bytes + LF)
     const QByteArray jsonHeaderSizeStr = preamble.mid(38, 8); // a fixed size text line (8 bytes + LF)
     bool ok;
     const int jsonHeaderSize = jsonHeaderSizeStr.toInt(&ok);
@@ -50,6 +230,10 @@ bool OGPRParser::parseOGPRFile(const QString &filePath)
         return false;
     }
 
+    if (jsonHeaderBytes) {
+        *jsonHeaderBytes = jsonHeader;
+    }
+
     // Parse JSON Header
     const QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonHeader);
     if (jsonDoc.isNull()) {
@@ -60,110 +244,357 @@ bool OGPRParser::parseOGPRFile(const QString &filePath)
     QJsonObject jsonObj = jsonDoc.object();
     // Extract version information
     QJsonObject versionObj = jsonObj["version"].toObject();
-    m_ogprFile.header.majorVersion = versionObj["major"].toInt();
-    m_ogprFile.header.minorVersion = versionObj["minor"].toInt();
+    ogprFile.header.majorVersion = versionObj["major"].toInt();
+    ogprFile.header.minorVersion = versionObj["minor"].toInt();
 
     // Extract main descriptor
     QJsonObject mainDescriptor = jsonObj["mainDescriptor"].toObject();
-    m_ogprFile.header.samplesCount = mainDescriptor["samplesCount"].toInt();
-    m_ogprFile.header.channelsCount = mainDescriptor["channelsCount"].toInt();
-    m_ogprFile.header.slicesCount = mainDescriptor["slicesCount"].toInt();
-    m_ogprFile.header.metadata = mainDescriptor["metadata"].toObject();
-
-    // Step 3: Read Data Blocks
-    QJsonArray dataBlockDescriptors = jsonObj["dataBlockDescriptors"].toArray();
+    ogprFile.header.samplesCount = mainDescriptor["samplesCount"].toInt();
+    ogprFile.header.channelsCount = mainDescriptor["channelsCount"].toInt();
+    ogprFile.header.slicesCount = mainDescriptor["slicesCount"].toInt();
+    ogprFile.header.metadata = mainDescriptor["metadata"].toObject();
+
+    // Extract data block descriptors
+    // 偏移与大小均按 64 位处理，超过 2 GiB 的数据块不会被截断
+    ogprFile.header.dataBlocks.clear();
+    const QJsonArray dataBlockDescriptors = jsonObj["dataBlockDescriptors"].toArray();
     for (const QJsonValue &blockValue : dataBlockDescriptors) {
-        QJsonObject blockObj = blockValue.toObject();
-        QString type = blockObj["type"].toString();
-        const auto byteSize = blockObj["byteSize"].toInt();
-        const auto byteOffset = blockObj["byteOffset"].toInt();
-
-        // Read binary data block
-        file.seek(byteOffset);
-        QByteArray dataBlock = file.read(byteSize);
-        if (dataBlock.size() < byteSize) {
-            qWarning() << "Failed to read data block:" << blockObj["name"].toString();
-            continue;
-        }
-
-        // Process binary data block based on type
-        if (type == "Radar Volume") {
-            if (const auto ret = parseRadarVolume(dataBlock, blockObj); !ret) {
-                qWarning() << "Failed to parse Radar Volume";
-                return false;
-            }
-        } else if (type == "Sample Geolocations") {
-            if (const auto ret = parseSampleGeolocations(dataBlock, blockObj); !ret) {
-                qWarning() << "Failed to parse Sample Geolocations";
-                return false;
-            }
-        }
+        ogprFile.header.dataBlocks.append(
+            DataBlockDescriptor::fromQJsonObject(blockValue.toObject()));
     }
+    return true;
+}
 
-    // Step 4: Read Epilogue
-    const QByteArray epilogue = file.read(33); // Fixed size epilogue
-    if (epilogue.size() < 33) {
-        qWarning() << "Invalid file format: Epilogue too short";
+// 只读取前导与 JSON 头，不读取任何数据块
+bool OGPRParser::probeOGPRFile(const QString &filePath, OpenGPRHeader &header)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open file:" << filePath;
         return false;
     }
 
-    // Verify MD5 checksum
-    if (const QByteArray epilogueMd5 = epilogue.mid(1, 32); epilogueMd5 != m_ogprFile.md5) {
-        qWarning() << "MD5 checksum mismatch";
+    OpenGPRFile ogprFile{};
+    if (!readHeader(file, ogprFile)) {
         return false;
     }
+
+    // 数据块的描述信息来自 JSON 头，无需读取负载
+    for (const DataBlockDescriptor &block : std::as_const(ogprFile.header.dataBlocks)) {
+        if (block.type == "Radar Volume") {
+            RadarVolume volume;
+            volume.name = block.name;
+            volume.metadata = block.json["metadata"].toObject();
+            QJsonObject radar = block.json["radar"].toObject();
+            if (!radar.isEmpty()) {
+                volume.radarInfo = RadarInfo(radar);
+            }
+            ogprFile.header.radarVolumes.append(volume);
+        } else if (block.type == "Sample Geolocations") {
+            ogprFile.header.sampleGeolocations.name = block.name;
+            ogprFile.header.sampleGeolocations.srs = block.json["srs"].toObject();
+        }
+    }
+    header = std::move(ogprFile.header);
     return true;
 }
 
+// 并行探测多个文件，单个文件的耗时主要是打开文件与读取头部的 I/O 延迟
+QVector<OGPRProbeResult> OGPRParser::probeOGPRFiles(const QStringList &filePaths)
+{
+    QVector<OGPRProbeResult> results(filePaths.size());
+    OGPRProbeResult *out = results.data();
+    const int count = int(filePaths.size());
+
+    ParallelScheduler::instance().parallelFor(0, count, 8, [&](const std::int64_t first, const std::int64_t last) {
+        for (std::int64_t i = first; i < last; ++i) {
+            out[i].filePath = filePaths.at(i);
+            out[i].ok = probeOGPRFile(out[i].filePath, out[i].header);
+        }
+    });
+    return results;
+}
+
 // 获取 BScan 切片（通道方向）
 Eigen::MatrixXf OGPRParser::getBScan(const int channelIndex)
 {
-    // 获取切片后的二维张量
-    Eigen::Tensor<float, 2> tensorSlice = m_ogprFile.header.radarVolume.data.chip(channelIndex, 1);
-
-    // 直接使用 Eigen::Map 映射数据
-    return Eigen::Map<Eigen::MatrixXf>(
-        tensorSlice.data(),
-        tensorSlice.dimension(0), // 行数
-        tensorSlice.dimension(1)  // 列数
-    );
+    Eigen::MatrixXf bScan;
+    copyBScan(channelIndex, bScan);
+    return bScan;
 }
 
 // 获取 CScan 切片（深度方向）
 Eigen::MatrixXf OGPRParser::getCScan(const int depthIndex) const
 {
-    // 获取沿第 2 维度切片的 Eigen::Tensor
-    Eigen::Tensor<float, 2> tensorSlice = m_ogprFile.header.radarVolume.data.chip(depthIndex, 0);
-
-    // 使用 Eigen::Map 将数据映射到 Eigen::Matrix
-    return Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>>(
-        tensorSlice.data(),
-        tensorSlice.dimension(0), // 行数
-        tensorSlice.dimension(1)  // 列数
-    );
+    Eigen::MatrixXf cScan;
+    copyCScan(depthIndex, cScan);
+    return cScan;
 }
 
 // 获取 TScan 切片（行进方向）
 Eigen::MatrixXf OGPRParser::getTScan(const int sliceIndex) const
+{
+    Eigen::MatrixXf tScan;
+    copyTScan(sliceIndex, tScan);
+    return tScan;
+}
+
+// 列优先 (samples, channels, slices) 布局下：
+// BScan 的列为同一通道的各切片，行连续、列步长为 samples * channels；
+// CScan 的行为同一深度的各通道，行步长为 samples，列步长为 samples * channels；
+// TScan 即单个切片，整体连续
+std::optional<ScanView> OGPRParser::bScanView(const int channelIndex) const
+{
+    const auto &data = activeVolume().data;
+    if (data.size() == 0) {
+        return std::nullopt;
+    }
+    if (channelIndex < 0 || channelIndex >= data.dimension(1)) {
+        throw std::out_of_range("Invalid channel index");
+    }
+    const Eigen::Index samples = data.dimension(0);
+    const Eigen::Index sliceStride = samples * data.dimension(1);
+    return ScanView(
+        data.data() + channelIndex * samples,
+        samples,
+        data.dimension(2),
+        Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(sliceStride, 1));
+}
+
+std::optional<ScanView> OGPRParser::cScanView(const int depthIndex) const
+{
+    const auto &data = activeVolume().data;
+    if (data.size() == 0) {
+        return std::nullopt;
+    }
+    if (depthIndex < 0 || depthIndex >= data.dimension(0)) {
+        throw std::out_of_range("Invalid depth index");
+    }
+    const Eigen::Index samples = data.dimension(0);
+    const Eigen::Index sliceStride = samples * data.dimension(1);
+    return ScanView(
+        data.data() + depthIndex,
+        data.dimension(1),
+        data.dimension(2),
+        Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(sliceStride, samples));
+}
+
+std::optional<ScanView> OGPRParser::tScanView(const int sliceIndex) const
+{
+    const auto &data = activeVolume().data;
+    if (data.size() == 0) {
+        return std::nullopt;
+    }
+    if (sliceIndex < 0 || sliceIndex >= data.dimension(2)) {
+        throw std::out_of_range("Invalid volume index");
+    }
+    const Eigen::Index samples = data.dimension(0);
+    const Eigen::Index channels = data.dimension(1);
+    return ScanView(
+        data.data() + sliceIndex * samples * channels,
+        samples,
+        channels,
+        Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(samples, 1));
+}
+
+void OGPRParser::copyBScan(const int channelIndex, Eigen::MatrixXf &out, const int slicesCount) const
+{
+    const auto &volume = activeVolume();
+    if (!m_brickedVolume.isEmpty()) {
+        m_brickedVolume.extractBScan(channelIndex, out);
+        if (slicesCount >= 0 && slicesCount < out.cols()) {
+            out.conservativeResize(Eigen::NoChange, slicesCount);
+        }
+    } else if (volume.hasNativeSamples()) {
+        volume.samples.extractBScan(channelIndex, out, slicesCount);
+    } else if (const auto view = bScanView(channelIndex)) {
+        if (slicesCount >= 0 && slicesCount < view->cols()) {
+            out = view->leftCols(slicesCount);
+        } else {
+            out = *view;
+        }
+    } else {
+        out.resize(0, 0);
+    }
+}
+
+void OGPRParser::copyBScanRange(
+    const int channelIndex, const qint64 firstSlice, const qint64 slicesCount, Eigen::MatrixXf &out) const
+{
+    const auto &volume = activeVolume();
+    if (!m_brickedVolume.isEmpty()) {
+        m_brickedVolume.extractBScanRange(channelIndex, firstSlice, slicesCount, out);
+    } else if (volume.hasNativeSamples()) {
+        volume.samples.extractBScanRange(channelIndex, firstSlice, slicesCount, out);
+    } else if (const auto view = bScanView(channelIndex)) {
+        const qint64 first = std::clamp<qint64>(firstSlice, 0, view->cols());
+        out = view->middleCols(first, std::clamp<qint64>(slicesCount, 0, view->cols() - first));
+    } else {
+        out.resize(0, 0);
+    }
+}
+
+void OGPRParser::copyCScan(const int depthIndex, Eigen::MatrixXf &out) const
+{
+    const auto &volume = activeVolume();
+    if (!m_brickedVolume.isEmpty()) {
+        m_brickedVolume.extractCScan(depthIndex, out);
+    } else if (volume.hasNativeSamples()) {
+        volume.samples.extractCScan(depthIndex, out);
+    } else if (const auto view = cScanView(depthIndex)) {
+        out = *view;
+    } else {
+        out.resize(0, 0);
+    }
+}
+
+void OGPRParser::copyTScan(const int sliceIndex, Eigen::MatrixXf &out) const
 {
     if (sliceIndex < 0) {
         throw std::out_of_range("Invalid volume index");
     }
 
-    // 获取沿第 0 维度切片的 Eigen::Tensor
-    Eigen::Tensor<float, 2> tensorSlice = m_ogprFile.header.radarVolume.data.chip(sliceIndex, 2);
+    const auto &volume = activeVolume();
+    if (!m_brickedVolume.isEmpty()) {
+        m_brickedVolume.extractTScan(sliceIndex, out);
+    } else if (volume.hasNativeSamples()) {
+        volume.samples.extractTScan(sliceIndex, out);
+    } else if (const auto view = tScanView(sliceIndex)) {
+        out = *view;
+    } else {
+        out.resize(0, 0);
+    }
+}
+
+bool OGPRParser::buildBrickedLayout(const int brickSize, const bool releaseLinearLayout)
+{
+    if (m_ogprFile.header.radarVolumes.isEmpty()) {
+        qWarning() << "No radar volume to build bricked layout from";
+        return false;
+    }
+    auto &volume = m_ogprFile.header.radarVolumes[m_activeVolume];
+    m_brickedVolume = BrickedVolume(brickSize);
+    if (volume.hasNativeSamples()) {
+        m_brickedVolume.build(volume.samples);
+    } else if (volume.data.size() > 0) {
+        m_brickedVolume.build(volume.data);
+    } else {
+        qWarning() << "No radar volume to build bricked layout from";
+        return false;
+    }
 
-    // 使用 Eigen::Map 将数据映射到 Eigen::Matrix
-    return Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic>>(
-        tensorSlice.data(),
-        tensorSlice.dimension(0), // 行数
-        tensorSlice.dimension(1)  // 列数
-    );
+    if (releaseLinearLayout) {
+        volume.data = Eigen::Tensor<float, 3>();
+        volume.samples.clear();
+    }
+    return true;
+}
+
+void OGPRParser::releaseBrickedLayout()
+{
+    m_brickedVolume.clear();
+}
+
+const BrickedVolume &OGPRParser::getBrickedVolume() const
+{
+    return m_brickedVolume;
+}
+
+bool OGPRParser::buildOverviewPyramid(const ScanPyramid::Reduction reduction)
+{
+    const auto shape = getRadarVolumeShape(m_activeVolume);
+    if (shape.size() != 3 || shape[0] * shape[1] * shape[2] == 0) {
+        qWarning() << "No radar volume to build overview pyramid from";
+        return false;
+    }
+    // 逐切片读取，线性布局、原始采样与砖块布局均可作为来源
+    m_overviewPyramid.build(
+        shape[0],
+        shape[1],
+        shape[2],
+        [this](const Eigen::Index sliceIndex, Eigen::MatrixXf &out) {
+            copyTScan(int(sliceIndex), out);
+        },
+        reduction);
+    return true;
+}
+
+void OGPRParser::releaseOverviewPyramid()
+{
+    m_overviewPyramid.clear();
+}
+
+const ScanPyramid &OGPRParser::getOverviewPyramid() const
+{
+    return m_overviewPyramid;
+}
+
+int OGPRParser::copyOverviewBScan(const int channelIndex, const int width, Eigen::MatrixXf &out) const
+{
+    const int level = m_overviewPyramid.levelForWidth(width);
+    if (level == 0) {
+        copyBScan(channelIndex, out);
+    } else {
+        out = m_overviewPyramid.bScan(level, channelIndex);
+    }
+    return level;
+}
+
+OGPRParser::ChecksumStatus OGPRParser::checksumStatus(const bool wait)
+{
+    // 内存映射模式的延迟校验在第一次查询时开始
+    if (m_checksumStatus == ChecksumStatus::Pending && !m_checksumVerifier.isStarted() && m_mappedData) {
+        m_checksumVerifier.start(m_mappedData + 47, m_checksumPayloadBytes);
+    }
+    if (m_checksumStatus == ChecksumStatus::Pending
+        && (wait || m_checksumVerifier.isFinished())) {
+        const QByteArray digest = m_checksumVerifier.result();
+        m_checksumStatus = !digest.isEmpty() && QString::fromLatin1(digest) == m_ogprFile.md5.toLower()
+                               ? ChecksumStatus::Valid
+                               : ChecksumStatus::Mismatch;
+        m_checksumVerifier.cancel();
+    }
+    return m_checksumStatus;
+}
+
+const RadarVolume &OGPRParser::activeVolume() const
+{
+    return m_ogprFile.header.radarVolume(m_activeVolume);
+}
+
+int OGPRParser::volumeCount() const
+{
+    return int(m_ogprFile.header.radarVolumes.size());
+}
+
+int OGPRParser::activeVolumeIndex() const
+{
+    return m_activeVolume;
+}
+
+bool OGPRParser::setActiveVolume(const int volumeIndex)
+{
+    if (volumeIndex < 0 || volumeIndex >= volumeCount()) {
+        qWarning() << "Invalid volume index:" << volumeIndex;
+        return false;
+    }
+    if (volumeIndex != m_activeVolume) {
+        // 砖块布局与概览金字塔只对应当前数据体
+        releaseBrickedLayout();
+        releaseOverviewPyramid();
+        m_activeVolume = volumeIndex;
+    }
+    return true;
 }
 
 const RadarVolume &OGPRParser::getRadarVolume() const
 {
-    return m_ogprFile.header.radarVolume;
+    return activeVolume();
+}
+
+const RadarVolume &OGPRParser::getRadarVolume(const int volumeIndex) const
+{
+    return m_ogprFile.header.radarVolume(volumeIndex);
 }
 
 const OpenGPRHeader &OGPRParser::getHeader() const
@@ -176,10 +607,26 @@ const SampleGeolocations &OGPRParser::getSampleGeolocations() const
     return m_ogprFile.header.sampleGeolocations;
 }
 
+const GeolocationIndex &OGPRParser::getGeolocationIndex() const
+{
+    return m_geolocationIndex;
+}
+
 // 获取雷达数据块的形状
 std::vector<Eigen::DenseIndex> OGPRParser::getRadarVolumeShape(const int volumeIndex) const
 {
-    const auto &data = m_ogprFile.header.radarVolume.data;
+    const auto &volume = m_ogprFile.header.radarVolume(volumeIndex);
+    if (volumeIndex == m_activeVolume && !m_brickedVolume.isEmpty()) {
+        return {m_brickedVolume.samplesCount(),
+                m_brickedVolume.channelsCount(),
+                m_brickedVolume.slicesCount()};
+    }
+    if (volume.hasNativeSamples()) {
+        return {volume.samples.samplesCount(),
+                volume.samples.channelsCount(),
+                volume.samples.slicesCount()};
+    }
+    const auto &data = volume.data;
     return {data.dimension(0), data.dimension(1), data.dimension(2)};
 }
 
@@ -211,58 +658,259 @@ system that has acquired the Radar Data Volume).
 3. For each Sweep, Samples are stored from the shallowest to the
 deepest.
  */
-// 将数字值转换为电压值，支持微调参数
-inline float digital_to_voltage_calibrated(int digital_value,
-                                     int D_min_meas = -32768,
-                                     int D_max_meas = 32767,
-                                     float delta_a = 0.0,
-                                     float delta_b = 0.0) {
-    // 理论比例因子
-    float a = (D_max_meas - D_min_meas) / 40.0;
-    // 理论截距
-    float b = D_min_meas + 20.0 * a;
-    // 加入微调参数后的比例因子和截距
-    float a_adj = a + delta_a;
-    float b_adj = b + delta_b;
-    // 根据转换公式计算电压
-    float voltage = (digital_value - b_adj) / a_adj;
-    return voltage;
+// 按切片分块读取数据块：每次最多处理 chunkBytes 字节（至少一个切片），读缓冲区复用，
+// 峰值内存与数据块大小无关；内存映射模式下直接把映射页指针交给 consumer
+bool OGPRParser::readBlockSlices(
+    QFile &file,
+    const DataBlockDescriptor &block,
+    const qint64 sliceBytes,
+    const qint64 slicesCount,
+    const qint64 chunkBytes,
+    const SliceChunkConsumer &consumer)
+{
+    if (sliceBytes <= 0 || slicesCount < 0 || block.byteSize / sliceBytes < slicesCount) {
+        qWarning() << "Invalid data block size:" << block.name;
+        return false;
+    }
+    const qint64 slicesPerChunk = std::max<qint64>(1, chunkBytes / sliceBytes);
+
+    if (m_mappedData) {
+        const char *base = reinterpret_cast<const char *>(m_mappedData + block.byteOffset);
+        for (qint64 first = 0; first < slicesCount; first += slicesPerChunk) {
+            const qint64 count = std::min(slicesPerChunk, slicesCount - first);
+            if (!consumer(base + first * sliceBytes, first, count)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (!file.seek(block.byteOffset)) {
+        qWarning() << "Failed to seek data block:" << block.name;
+        return false;
+    }
+    // 两个缓冲区交替使用：一块送去计算 MD5 的同时转换它并读入下一块
+    QByteArray buffers[2];
+    for (qint64 first = 0, chunk = 0; first < slicesCount; first += slicesPerChunk, ++chunk) {
+        const qint64 count = std::min(slicesPerChunk, slicesCount - first);
+        const qint64 bytes = count * sliceBytes;
+        QByteArray &buffer = buffers[chunk % 2];
+        buffer.resize(bytes);
+        if (file.read(buffer.data(), bytes) != bytes) {
+            qWarning() << "Failed to read data block:" << block.name;
+            return false;
+        }
+        m_checksumVerifier.addData(block.byteOffset + first * sliceBytes, buffer);
+        if (!consumer(buffer.constData(), first, count)) {
+            return false;
+        }
+    }
+    return true;
 }
+
 // 优化版
 // 解析雷达数据块
-bool OGPRParser::parseRadarVolume(const QByteArray &data, const QJsonObject &blockObj)
+bool OGPRParser::parseRadarVolume(
+    QFile &file,
+    const DataBlockDescriptor &block,
+    const OGPRLoadOptions &options,
+    const int volumeIndex,
+    RadarVolume &volume)
 {
-    m_ogprFile.header.radarVolume.name = blockObj["name"].toString();
-    m_ogprFile.header.radarVolume.metadata = blockObj["metadata"].toObject();
-    QJsonObject radar = blockObj["radar"].toObject();
+    volume.name = block.name;
+    volume.metadata = block.json["metadata"].toObject();
+    QJsonObject radar = block.json["radar"].toObject();
     if (radar.isEmpty()) {
         qWarning() << "Radar object is empty";
         return false;
     }
-    m_ogprFile.header.radarVolume.radarInfo = RadarInfo(radar);
-    // 使用 Eigen::TensorMap 直接映射内存
-    const auto rawData = reinterpret_cast<const int16_t *>(data.constData());
-    // 这里一定要注意，Eigen::TensorMap 存储是按照列优先的，所以这里的维度顺序是 (samplesCount, channelsCount, slicesCount)
-    const Eigen::TensorMap<Eigen::Tensor<const int16_t, 3>> tensorMap(
-        rawData,
-        m_ogprFile.header.samplesCount,
-        m_ogprFile.header.channelsCount,
-        m_ogprFile.header.slicesCount);
-    // 转换为电压值：两个步骤合并
-    m_ogprFile.header.radarVolume.data = std::move(
-        tensorMap.unaryExpr([](int16_t val) {
-            return digital_to_voltage_calibrated(val);
-        }));
-
-    // qDebug() << "Tensor size: " << tensorMap.size();
-    // qDebug() << "Tensor memory size: " << sizeof(tensorMap);
-    // 直接将 tensorMap 赋值给 radarVolume.data
-    // m_ogprFile.header.radarVolume.data = std::move(
-    //     tensorMap.cast<float>()); // 使用 std::move 避免复制
-    // 输出最大最小值
-    std::cout << "Max value: " << m_ogprFile.header.radarVolume.data.maximum();
-    std::cout << "Min value: " << m_ogprFile.header.radarVolume.data.minimum();
+    volume.radarInfo = RadarInfo(radar);
+
+    // 这里一定要注意，Eigen::Tensor 存储是按照列优先的，所以这里的维度顺序是 (samplesCount, channelsCount, slicesCount)
+    const qint64 samples = m_ogprFile.header.samplesCount;
+    const qint64 channels = m_ogprFile.header.channelsCount;
+    const qint64 slices = m_ogprFile.header.slicesCount;
+    const qint64 sliceSamples = samples * channels;
+    const qint64 sliceBytes = sliceSamples * qint64(sizeof(int16_t));
+
+    volume.data = Eigen::Tensor<float, 3>();
+    volume.samples.clear();
+    volume.samples.setCalibration(VoltageCalibration::fromDigitalRange());
+
+    // 压缩编码的数据块
+    if (const QString encoding = block.json["encoding"].toString(); !encoding.isEmpty()) {
+        if (encoding != kTraceCodecName) {
+            qWarning() << "Unsupported radar volume encoding:" << encoding;
+            return false;
+        }
+        return parseEncodedRadarVolume(file, block, options, volumeIndex, volume);
+    }
+
+    if (sliceBytes <= 0 || block.byteSize / sliceBytes < slices) {
+        qWarning() << "Invalid radar volume data block size";
+        return false;
+    }
+
+    // 内存映射模式：只保留映射页上的视图，不做整体转换
+    if (m_mappedData) {
+        volume.samples.setView(
+            reinterpret_cast<const int16_t *>(m_mappedData + block.byteOffset),
+            samples,
+            channels,
+            slices);
+        // 映射后全部切片立即可用
+        return !options.sliceProgress || options.sliceProgress(volumeIndex, 0, slices);
+    }
+
+    // 失败时不释放已分配的内存：渐进加载中已发布的切片可能仍在被读取，下次解析时才重置
+
+    // 保留原始采样：逐块拷贝 int16，不做转换
+    if (options.keepNativeSamples) {
+        volume.samples.allocate(samples, channels, slices);
+        const bool ok = readBlockSlices(
+            file,
+            block,
+            sliceBytes,
+            slices,
+            options.chunkBytes,
+            [&](const char *data, const qint64 firstSlice, const qint64 sliceCount) {
+                std::memcpy(
+                    volume.samples.mutableData() + firstSlice * sliceSamples,
+                    data,
+                    sliceCount * sliceBytes);
+                return !options.sliceProgress
+                       || options.sliceProgress(volumeIndex, firstSlice, sliceCount);
+            });
+        return ok;
+    }
+
+    // 预先分配张量，再逐块读取并转换为电压值，原始字节不会整体驻留内存
+    volume.data.resize(samples, channels, slices);
+    const bool ok = readBlockSlices(
+        file,
+        block,
+        sliceBytes,
+        slices,
+        options.chunkBytes,
+        [&](const char *data, const qint64 firstSlice, const qint64 sliceCount) {
+            // 向量化内核按切片并行转换
+            convertSlicesToVoltage(
+                reinterpret_cast<const int16_t *>(data),
+                volume.data.data() + firstSlice * sliceSamples,
+                sliceSamples,
+                sliceCount,
+                volume.samples.calibration());
+            return !options.sliceProgress
+                   || options.sliceProgress(volumeIndex, firstSlice, sliceCount);
+        });
+    return ok;
+}
+
+// 解析压缩编码的雷达数据块：先读偏移表，再按批读取压缩切片并行解码。
+// 压缩数据无法作为映射视图，内存映射模式下也解码为内存中的原始采样
+bool OGPRParser::parseEncodedRadarVolume(
+    QFile &file,
+    const DataBlockDescriptor &block,
+    const OGPRLoadOptions &options,
+    const int volumeIndex,
+    RadarVolume &volume)
+{
+    const qint64 samples = m_ogprFile.header.samplesCount;
+    const qint64 channels = m_ogprFile.header.channelsCount;
+    const qint64 slices = m_ogprFile.header.slicesCount;
+    const qint64 sliceSamples = samples * channels;
+    const qint64 sliceBytes = sliceSamples * qint64(sizeof(int16_t));
+    const qint64 tableBytes = (slices + 1) * qint64(sizeof(quint64));
+    if (sliceSamples <= 0 || slices < 0 || block.byteSize < tableBytes) {
+        qWarning() << "Invalid radar volume data block size";
+        return false;
+    }
+
+    // 偏移表，相对偏移表之后的位置
+    std::vector<quint64> offsets(slices + 1);
+    if (m_mappedData) {
+        std::memcpy(offsets.data(), m_mappedData + block.byteOffset, tableBytes);
+    } else {
+        const QByteArray table = file.seek(block.byteOffset) ? file.read(tableBytes) : QByteArray();
+        if (table.size() != tableBytes) {
+            qWarning() << "Failed to read data block:" << block.name;
+            return false;
+        }
+        m_checksumVerifier.addData(block.byteOffset, table);
+        std::memcpy(offsets.data(), table.constData(), tableBytes);
+    }
+    for (qint64 slice = 0; slice < slices; ++slice) {
+        if (offsets[slice + 1] < offsets[slice]) {
+            qWarning() << "Invalid radar volume slice offsets";
+            return false;
+        }
+    }
+    if (offsets[0] != 0 || offsets[slices] > quint64(block.byteSize - tableBytes)) {
+        qWarning() << "Invalid radar volume slice offsets";
+        return false;
+    }
+
+    const bool native = options.keepNativeSamples || m_mappedData;
+    if (native) {
+        volume.samples.allocate(samples, channels, slices);
+    } else {
+        volume.data.resize(samples, channels, slices);
+    }
+
+    const qint64 dataOffset = block.byteOffset + tableBytes;
+    // 与 readBlockSlices 相同，两个缓冲区交替读入并送去计算 MD5
+    QByteArray buffers[2];
+    qint64 batch = 0;
+    std::vector<int16_t> decoded;
+    for (qint64 first = 0; first < slices;) {
+        // 一批切片的压缩字节与解码字节都不超过 chunkBytes（至少一个切片）
+        qint64 last = first + 1;
+        while (last < slices && qint64(offsets[last + 1] - offsets[first]) <= options.chunkBytes
+               && (last + 1 - first) * sliceBytes <= options.chunkBytes) {
+            ++last;
+        }
+        const qint64 count = last - first;
+        const qint64 encodedBytes = qint64(offsets[last] - offsets[first]);
+
+        const uchar *src = nullptr;
+        if (m_mappedData) {
+            src = m_mappedData + dataOffset + offsets[first];
+        } else {
+            QByteArray &buffer = buffers[batch++ % 2];
+            buffer.resize(encodedBytes);
+            if (!file.seek(dataOffset + qint64(offsets[first]))
+                || file.read(buffer.data(), encodedBytes) != encodedBytes) {
+                qWarning() << "Failed to read data block:" << block.name;
+                return false;
+            }
+            m_checksumVerifier.addData(dataOffset + qint64(offsets[first]), buffer);
+            src = reinterpret_cast<const uchar *>(buffer.constData());
+        }
 
+        int16_t *dst = nullptr;
+        if (native) {
+            dst = volume.samples.mutableData() + first * sliceSamples;
+        } else {
+            decoded.resize(size_t(count * sliceSamples));
+            dst = decoded.data();
+        }
+        if (!decodeSlices(src, offsets.data() + first, dst, sliceSamples, count)) {
+            qWarning() << "Corrupted radar volume data block:" << block.name;
+            return false;
+        }
+        if (!native) {
+            convertSlicesToVoltage(
+                dst,
+                volume.data.data() + first * sliceSamples,
+                sliceSamples,
+                count,
+                volume.samples.calibration());
+        }
+        if (options.sliceProgress && !options.sliceProgress(volumeIndex, first, count)) {
+            return false;
+        }
+        first = last;
+    }
     return true;
 }
 
@@ -291,62 +939,77 @@ bool OGPRParser::parseRadarVolume(const QByteArray &data, const QJsonObject &blo
 // }
 
 // 解析地理定位数据块
-bool OGPRParser::parseSampleGeolocations(const QByteArray &data, const QJsonObject &blockObj)
+bool OGPRParser::parseSampleGeolocations(
+    QFile &file, const DataBlockDescriptor &block, const OGPRLoadOptions &options)
 {
-    m_ogprFile.header.sampleGeolocations.name = blockObj["name"].toString();
-    m_ogprFile.header.sampleGeolocations.srs = blockObj["srs"].toObject();
+    auto &geolocations = m_ogprFile.header.sampleGeolocations;
+    geolocations.name = block.name;
+    geolocations.srs = block.json["srs"].toObject();
+    m_geolocationIndex.clear();
 
     // 获取切片数量
-    const int slicesCount = m_ogprFile.header.slicesCount;
+    const qint64 slicesCount = m_ogprFile.header.slicesCount;
     // 获取通道数量
-    const int channelsCount = m_ogprFile.header.channelsCount;
+    const qint64 channelsCount = m_ogprFile.header.channelsCount;
+
+    // 一次性分配全部字段，解析时按下标写入
+    geolocations.slicesCount = slicesCount;
+    geolocations.channelsCount = channelsCount;
+    geolocations.sliceIds.resize(slicesCount);
+    geolocations.shallow.resize(slicesCount * channelsCount);
+    geolocations.deep.resize(slicesCount * channelsCount);
 
     // 每个坐标块由4个双精度浮点数组成（x, y, depth, elevation）
-    constexpr int coordsPerBlock = 4;
+    constexpr qint64 coordsPerBlock = 4;
     // 每个扫描块包含2个坐标块
-    constexpr int blocksPerSweep = 2;
+    constexpr qint64 blocksPerSweep = 2;
     // 每个切片块包含一个64位整数（切片标识）和多个扫描块
-    constexpr int sliceIdSize = sizeof(int64_t);
+    constexpr qint64 sliceIdSize = sizeof(int64_t);
 
     // 计算每个切片块的大小
-    const int sliceBlockSize = sliceIdSize
-                               + channelsCount * blocksPerSweep * coordsPerBlock * sizeof(double);
-
-    // 计算总的地理定位数据大小
-    // 检查数据块大小是否匹配
-    if (const int totalGeolocationsSize = slicesCount * sliceBlockSize;
-        data.size() < totalGeolocationsSize) {
-        qWarning() << "Invalid geolocations data block size";
+    const qint64 sliceBlockSize = sliceIdSize
+                                  + channelsCount * blocksPerSweep * coordsPerBlock
+                                        * qint64(sizeof(double));
+
+    const auto storeBlock = [](GeolocationCoordinates &target, const qsizetype index, const double *coords) {
+        target.x[index] = coords[0];
+        target.y[index] = coords[1];
+        target.depth[index] = coords[2];
+        target.elevation[index] = coords[3];
+    };
+
+    // 按切片分块解析，数据块大小在 readBlockSlices 中检查
+    const bool ok = readBlockSlices(
+        file,
+        block,
+        sliceBlockSize,
+        slicesCount,
+        options.chunkBytes,
+        [&](const char *data, const qint64 firstSlice, const qint64 sliceCount) {
+            for (qint64 slice = 0; slice < sliceCount; ++slice) {
+                const char *sliceData = data + slice * sliceBlockSize;
+                const qint64 sliceIndex = firstSlice + slice;
+                std::memcpy(&geolocations.sliceIds[sliceIndex], sliceData, sliceIdSize);
+                sliceData += sliceIdSize;
+                for (qint64 channel = 0; channel < channelsCount; ++channel) {
+                    // 第一个坐标块为最小深度的坐标，第二个坐标块为最大深度的坐标
+                    double coords[blocksPerSweep * coordsPerBlock];
+                    std::memcpy(
+                        coords,
+                        sliceData + channel * blocksPerSweep * coordsPerBlock * sizeof(double),
+                        sizeof(coords));
+                    const qsizetype index = geolocations.sweepIndex(sliceIndex, channel);
+                    storeBlock(geolocations.shallow, index, coords);
+                    storeBlock(geolocations.deep, index, coords + coordsPerBlock);
+                }
+            }
+            return true;
+        });
+    if (!ok) {
         return false;
     }
 
-    // 使用 Eigen::Tensor 存储地理定位数据
-    // 地理定位数据的形状为 (slicesCount, channelsCount, 2, 4)
-    // 其中 2 表示每个扫描块的两个坐标块，4 表示每个坐标块的四个坐标值
-    // geolocations.geolocations = Eigen::Tensor<double, 4>(slicesCount, channelsCount, blocksPerSweep, coordsPerBlock);
-
-    // 解析地理定位数据
-    const auto rawData = reinterpret_cast<const double *>(data.constData());
-    int index = 0;
-
-    for (int slice = 0; slice < slicesCount; ++slice) {
-        // 跳过切片标识（64位整数）
-        index += sliceIdSize / sizeof(double);
-
-        for (int channel = 0; channel < channelsCount; ++channel) {
-            // 解析第一个坐标块（最小深度的坐标）
-            double x = rawData[index++];         // 经度
-            double y = rawData[index++];         // 纬度
-            double depth = rawData[index++];     // 深度, 不使用但是需要解析，因为要index++
-            double elevation = rawData[index++]; // 标高 同上
-
-            // 只存储经纬度信息
-            m_ogprFile.header.sampleGeolocations.latLonCoordinates.append(qMakePair(x, y));
-
-            // 跳过第二个坐标块（最大深度的坐标）
-            index += coordsPerBlock;
-        }
-    }
-
+    // 按最小深度坐标的平面位置建立空间索引
+    m_geolocationIndex.build(geolocations);
     return true;
 }
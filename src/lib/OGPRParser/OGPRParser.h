@@ -2,6 +2,7 @@
 #define OGPRParser_H
 
 #include <QString>
+#include <QStringList>
 #include <QVector>
 #include <QJsonObject>
 #include <QFile>
@@ -10,6 +11,14 @@
 #include <QDebug>
 #include <unsupported/Eigen/CXX11/Tensor> // 引入 Eigen::Tensor
 #include <Eigen/Dense> // 包含 Eigen::Matrix
+#include "BrickedVolume.h"
+#include "ScanPyramid.h"
+#include "ChecksumVerifier.h"
+#include "GeolocationIndex.h"
+#include "VolumeStorage.h"
+#include <functional>
+#include <memory>
+#include <optional>
 
 struct RadarInfo {
     float samplingStep_m;
@@ -71,13 +80,74 @@ struct RadarVolume {
     Eigen::Tensor<float, 3> data; // 使用 Eigen::Tensor 存储雷达数据
     QJsonObject metadata;
     RadarInfo radarInfo;
+    // 原始 int16 采样及标定系数（内存映射或保留原始采样时使用），此时 data 为空，
+    // 切片在提取时才转换为电压值
+    VolumeStorage<int16_t> samples;
+
+    bool isMapped() const {
+        return samples.isView();
+    }
+
+    bool hasNativeSamples() const {
+        return !samples.isEmpty();
+    }
 };
 
 // 地理定位数据块
+// 一个坐标块的全部字段，按结构数组存储，下标为 slice * channelsCount + channel
+struct GeolocationCoordinates {
+    QVector<double> x;
+    QVector<double> y;
+    QVector<double> depth;
+    QVector<double> elevation;
+
+    void resize(qsizetype count) {
+        x.resize(count);
+        y.resize(count);
+        depth.resize(count);
+        elevation.resize(count);
+    }
+};
+
 struct SampleGeolocations {
     QString name;
     QJsonObject srs; // 空间参考系统
-    QVector<QPair<double, double> > latLonCoordinates;  // 用于存储经纬度信息
+    qint64 slicesCount = 0;
+    qint64 channelsCount = 0;
+    QVector<qint64> sliceIds;        // 切片标识
+    GeolocationCoordinates shallow;  // 第一个坐标块（最小深度）
+    GeolocationCoordinates deep;     // 第二个坐标块（最大深度）
+
+    qsizetype sweepIndex(qint64 slice, qint64 channel) const {
+        return qsizetype(slice * channelsCount + channel);
+    }
+
+    bool isEmpty() const {
+        return shallow.x.isEmpty();
+    }
+};
+
+// 数据块描述符，偏移与大小为 64 位
+struct DataBlockDescriptor {
+    QString type;
+    QString name;
+    qint64 byteOffset = 0;
+    qint64 byteSize = 0;
+    QJsonObject json; // 完整的描述符对象
+
+    DataBlockDescriptor() = default;
+
+    explicit DataBlockDescriptor(const QJsonObject &obj)
+        : type(obj["type"].toString())
+        , name(obj["name"].toString())
+        , byteOffset(obj["byteOffset"].toInteger())
+        , byteSize(obj["byteSize"].toInteger())
+        , json(obj)
+    {}
+
+    static DataBlockDescriptor fromQJsonObject(const QJsonObject &obj) {
+        return DataBlockDescriptor(obj);
+    }
 };
 
 // JSON 头文件
@@ -88,23 +158,34 @@ struct OpenGPRHeader {
     int channelsCount;
     int slicesCount;
     QJsonObject metadata;
-    RadarVolume radarVolume;
+    QVector<DataBlockDescriptor> dataBlocks;
+    // 文件中的全部雷达数据块（如不同极化或频率），按描述符顺序
+    QVector<RadarVolume> radarVolumes;
     SampleGeolocations sampleGeolocations;
 
+    // 指定的雷达数据块，越界时返回空数据块
+    const RadarVolume &radarVolume(int volumeIndex = 0) const {
+        static const RadarVolume empty{};
+        if (volumeIndex < 0 || volumeIndex >= radarVolumes.size()) {
+            return empty;
+        }
+        return radarVolumes[volumeIndex];
+    }
+
     int maxChannels() const {
         return channelsCount;
     }
 
     // 单位为 m
     int maxPositionM() const {
-        return slicesCount * radarVolume.radarInfo.samplingStep_m;
+        return slicesCount * radarVolume().radarInfo.samplingStep_m;
     }
     // 单位为 cm
     int maxDepth() const {
         // qDebug() << "samplesCount: " << samplesCount;
         // qDebug() << "radarVolume.radarInfo.samplingTime_ns: " << radarVolume.radarInfo.samplingTime_ns;
         // qDebug() << "radarVolume.radarInfo.propagationVelocity_mPerSec: " << radarVolume.radarInfo.propagationVelocity_mPerSec;
-        return samplesCount * radarVolume.radarInfo.samplingTime_ns * radarVolume.radarInfo.propagationVelocity_mPerSec * 1e-9 * 100 / 2;
+        return samplesCount * radarVolume().radarInfo.samplingTime_ns * radarVolume().radarInfo.propagationVelocity_mPerSec * 1e-9 * 100 / 2;
     }
 };
 
@@ -115,8 +196,53 @@ struct OpenGPRFile {
     OpenGPRHeader header;
 };
 
+// 头部探测结果
+struct OGPRProbeResult {
+    QString filePath;
+    bool ok = false;
+    OpenGPRHeader header; // 不含任何数据块负载
+};
+
+// 雷达数据体上的二维只读视图：按步长直接引用 RadarVolume::data，不拷贝
+using ScanView = Eigen::Map<const Eigen::MatrixXf,
+                            Eigen::Unaligned,
+                            Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+
+// 加载选项
+struct OGPRLoadOptions {
+    // 负载 MD5 校验方式：Skip 不校验；Verify 在后台线程中与解析重叠计算，解析结束时等待结果，
+    // 不匹配则解析失败；Deferred 解析不等待，结果通过 OGPRParser::checksumStatus() 查询。
+    // 拷贝模式下直接使用解析读入的数据计算（多个数据块并发解码时由校验线程另行读取）；内存映射模式下需要读取整个文件，
+    // Deferred 推迟到第一次查询 checksumStatus() 时才开始。Auto 在拷贝模式下为 Verify，内存映射模式下为 Deferred
+    enum class ChecksumMode {
+        Skip,
+        Verify,
+        Deferred,
+        Auto
+    };
+
+    // 使用 QFile::map 映射整个文件，雷达数据块作为映射页上的只读视图，
+    // 切片在提取时才按需换页并转换为电压值
+    bool memoryMapped = false;
+    // 拷贝模式下分块读取的字节数上限（至少一个切片），决定解析时的峰值额外内存
+    qint64 chunkBytes = 64 * 1024 * 1024;
+    // 拷贝模式下保留原始 int16 采样而不整体转换为 float，内存占用减半
+    bool keepNativeSamples = false;
+    ChecksumMode checksumMode = ChecksumMode::Auto;
+    // 每解码完雷达数据块中一段连续切片（按采集顺序）后调用，返回 false 取消解析。
+    // 多个数据块并发解码时可能在不同线程中调用，需自行保证线程安全
+    std::function<bool(int volumeIndex, qint64 firstSlice, qint64 sliceCount)> sliceProgress;
+};
+
 class OGPRParser {
 public:
+    enum class ChecksumStatus {
+        NotVerified,
+        Pending,
+        Valid,
+        Mismatch
+    };
+
     // 构造函数
     OGPRParser();
 
@@ -124,7 +250,13 @@ public:
     ~OGPRParser();
 
     // 解析 .ogpr 文件
-    bool parseOGPRFile(const QString &filePath);
+    bool parseOGPRFile(const QString &filePath, const OGPRLoadOptions &options = {});
+
+    // 快速探测：只读取 47 字节前导与 JSON 头，得到尺寸、RadarInfo 与数据块描述符，不读取负载
+    static bool probeOGPRFile(const QString &filePath, OpenGPRHeader &header);
+
+    // 并行探测一批文件，结果顺序与输入一致
+    static QVector<OGPRProbeResult> probeOGPRFiles(const QStringList &filePaths);
 
     // 获取 BScan 切片（通道方向）
     Eigen::MatrixXf getBScan(int channelIndex);
@@ -135,27 +267,127 @@ public:
     // 获取 TScan 切片（行进方向）
     Eigen::MatrixXf getTScan( int sliceIndex) const;
 
-    // 获取雷达数据块
+    // 零拷贝切片视图：仅当电压值已驻留在 RadarVolume::data 中时可用，否则返回 std::nullopt。
+    // BScan 为 (samples, slices)，CScan 为 (channels, slices)，TScan 为 (samples, channels)
+    std::optional<ScanView> bScanView(int channelIndex) const;
+    std::optional<ScanView> cScanView(int depthIndex) const;
+    std::optional<ScanView> tScanView(int sliceIndex) const;
+
+    // 将切片拷贝为连续矩阵，尺寸不变时复用 out 的内存，逐通道浏览时不再分配；
+    // BScan 可只取前 slicesCount 个切片（如渐进加载中已解码的部分），-1 为全部
+    void copyBScan(int channelIndex, Eigen::MatrixXf &out, int slicesCount = -1) const;
+    // 只拷贝 BScan 中 [firstSlice, firstSlice + slicesCount) 范围内的道，内存映射时只读取这部分数据
+    void copyBScanRange(int channelIndex, qint64 firstSlice, qint64 slicesCount, Eigen::MatrixXf &out) const;
+    void copyCScan(int depthIndex, Eigen::MatrixXf &out) const;
+    void copyTScan(int sliceIndex, Eigen::MatrixXf &out) const;
+
+    // 构建可选的砖块布局，之后 copy*Scan 均从砖块并行组装；
+    // releaseLinearLayout 为 true 时释放原有的线性布局以节省内存（零拷贝视图随之不可用）
+    bool buildBrickedLayout(int brickSize = 16, bool releaseLinearLayout = false);
+
+    // 释放砖块布局
+    void releaseBrickedLayout();
+
+    const BrickedVolume &getBrickedVolume() const;
+
+    // 构建当前数据块的概览金字塔（沿行进方向逐级减半），用于长测线的概览显示与处理；
+    // 总内存约等于一份电压数据体，重新解析或切换数据块时释放
+    bool buildOverviewPyramid(ScanPyramid::Reduction reduction = ScanPyramid::Reduction::MaxAbs);
+
+    // 释放概览金字塔
+    void releaseOverviewPyramid();
+
+    const ScanPyramid &getOverviewPyramid() const;
+
+    // 取迹线数不少于 width 的最粗一层的 BScan，返回所用层级（0 为原始数据，未构建金字塔时总是 0）
+    int copyOverviewBScan(int channelIndex, int width, Eigen::MatrixXf &out) const;
+
+    // 负载 MD5 校验状态，wait 为 true 时等待后台计算完成
+    ChecksumStatus checksumStatus(bool wait = false);
+
+    // 雷达数据块数量
+    int volumeCount() const;
+
+    // 切片获取、视图与砖块布局均作用于当前数据块，默认为第一个
+    int activeVolumeIndex() const;
+    bool setActiveVolume(int volumeIndex);
+
+    // 获取当前雷达数据块
     const RadarVolume &getRadarVolume() const;
 
+    // 获取指定的雷达数据块
+    const RadarVolume &getRadarVolume(int volumeIndex) const;
+
     // 获取道头信息
     const OpenGPRHeader &getHeader() const;
 
     // 获取地理定位数据块
     const SampleGeolocations &getSampleGeolocations() const;
 
+    // 地理定位的空间索引，解析地理定位块后构建
+    const GeolocationIndex &getGeolocationIndex() const;
+
     // 获取雷达数据块的形状
     std::vector<Eigen::DenseIndex> getRadarVolumeShape(int volumeIndex) const;
 
 private:
+    // 读取前导与 JSON 头，jsonHeader 非空时返回 JSON 头的原始字节
+    static bool readHeader(QFile &file, OpenGPRFile &ogprFile, QByteArray *jsonHeader = nullptr);
+
+    // 分块回调：data 指向 sliceCount 个连续切片，返回 false 终止读取
+    using SliceChunkConsumer
+        = std::function<bool(const char *data, qint64 firstSlice, qint64 sliceCount)>;
+
+    // 按切片分块读取数据块，峰值内存受 chunkBytes 限制
+    bool readBlockSlices(
+        QFile &file,
+        const DataBlockDescriptor &block,
+        qint64 sliceBytes,
+        qint64 slicesCount,
+        qint64 chunkBytes,
+        const SliceChunkConsumer &consumer);
+
     // 解析雷达数据块
-    bool parseRadarVolume(const QByteArray &data, const QJsonObject &blockObj);
+    bool parseRadarVolume(
+        QFile &file,
+        const DataBlockDescriptor &block,
+        const OGPRLoadOptions &options,
+        int volumeIndex,
+        RadarVolume &volume);
+
+    // 解析压缩编码的雷达数据块
+    bool parseEncodedRadarVolume(
+        QFile &file,
+        const DataBlockDescriptor &block,
+        const OGPRLoadOptions &options,
+        int volumeIndex,
+        RadarVolume &volume);
+
+    const RadarVolume &activeVolume() const;
 
     // 解析地理定位数据块
-    bool parseSampleGeolocations(const QByteArray &data, const QJsonObject &blockObj);
+    bool parseSampleGeolocations(
+        QFile &file, const DataBlockDescriptor &block, const OGPRLoadOptions &options);
+
+    // 释放内存映射
+    void releaseMapping();
 
     // 存储解析后的 .ogpr 文件数据
     OpenGPRFile m_ogprFile;
+    // 内存映射模式下保持打开的文件及映射地址
+    std::unique_ptr<QFile> m_mappedFile;
+    uchar *m_mappedData = nullptr;
+    // 可选的砖块布局
+    BrickedVolume m_brickedVolume;
+    ScanPyramid m_overviewPyramid;
+    // 后台 MD5 校验
+    ChecksumVerifier m_checksumVerifier;
+    GeolocationIndex m_geolocationIndex;
+    ChecksumStatus m_checksumStatus = ChecksumStatus::NotVerified;
+    // 内存映射模式下按需校验的负载字节数
+    qint64 m_checksumPayloadBytes = 0;
+    // 当前数据块
+    int m_activeVolume = 0;
 };
 
 #endif // OGPRParser_H
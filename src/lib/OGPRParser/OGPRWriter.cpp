@@ -0,0 +1,394 @@
+#include "OGPRWriter.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include "ParallelScheduler.h"
+#include "TraceCodec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr qint64 kPreambleSize = 47;
+// 每批转换的采样数上限
+constexpr qint64 kChunkSamples = 2 * 1024 * 1024;
+// 每个并行区间编码的切片数
+constexpr qint64 kEncodeSliceGrain = 4;
+
+// 地理定位块每个切片的字节数：切片标识 + 每通道两个坐标块，每块 4 个 double
+qint64 geolocationSliceBytes(const qint64 channels)
+{
+    return qint64(sizeof(int64_t)) + channels * 2 * 4 * qint64(sizeof(double));
+}
+
+// 每个坐标数组都须有 sweeps 项，否则写出的地理定位块会读越界
+bool hasSweepCount(const GeolocationCoordinates &coordinates, const qint64 sweeps)
+{
+    return coordinates.x.size() == sweeps && coordinates.y.size() == sweeps
+           && coordinates.depth.size() == sweeps && coordinates.elevation.size() == sweeps;
+}
+
+} // namespace
+
+OGPRWriter::~OGPRWriter()
+{
+    abort();
+}
+
+bool OGPRWriter::open(const QString &filePath,
+                      const qint64 samplesCount,
+                      const qint64 channelsCount,
+                      const qint64 slicesCount,
+                      const OGPRWriterOptions &options)
+{
+    abort();
+    if (samplesCount <= 0 || channelsCount <= 0 || slicesCount < 0) {
+        qWarning() << "Invalid volume shape for writing";
+        return false;
+    }
+    const SampleGeolocations *geolocations = options.geolocations;
+    if (geolocations
+        && (geolocations->slicesCount != slicesCount || geolocations->channelsCount != channelsCount
+            || geolocations->sliceIds.size() != slicesCount
+            || !hasSweepCount(geolocations->shallow, slicesCount * channelsCount)
+            || !hasSweepCount(geolocations->deep, slicesCount * channelsCount))) {
+        qWarning() << "Sample geolocations do not match the volume shape";
+        return false;
+    }
+
+    m_options = options;
+    m_filePath = filePath;
+    m_samples = samplesCount;
+    m_channels = channelsCount;
+    m_slices = slicesCount;
+    m_writtenSlices = 0;
+    m_md5.clear();
+    m_hash.reset();
+
+    if (options.compressTraces) {
+        m_spool = std::make_unique<QTemporaryFile>();
+        if (!m_spool->open()) {
+            qWarning() << "Failed to create temporary file for compressed slices";
+            m_spool.reset();
+            return false;
+        }
+        m_offsets.assign(1, 0);
+        return true;
+    }
+    return writeHeader(samplesCount * channelsCount * slicesCount * qint64(sizeof(int16_t)));
+}
+
+bool OGPRWriter::writeHeader(const qint64 volumeBytes)
+{
+    const SampleGeolocations *geolocations = m_options.geolocations;
+    const qint64 geolocationBytes = geolocations ? m_slices * geolocationSliceBytes(m_channels) : 0;
+
+    // 数据块偏移取决于 JSON 头的长度，而长度又随偏移的位数变化，迭代到不动点
+    const auto buildHeader = [&](const qint64 volumeOffset) {
+        QJsonObject version;
+        version["major"] = m_options.majorVersion;
+        version["minor"] = m_options.minorVersion;
+
+        QJsonObject mainDescriptor;
+        mainDescriptor["samplesCount"] = m_samples;
+        mainDescriptor["channelsCount"] = m_channels;
+        mainDescriptor["slicesCount"] = m_slices;
+        mainDescriptor["metadata"] = m_options.metadata;
+
+        QJsonObject volume;
+        volume["type"] = "Radar Volume";
+        volume["name"] = m_options.volumeName;
+        volume["byteOffset"] = volumeOffset;
+        volume["byteSize"] = volumeBytes;
+        volume["radar"] = m_options.radar;
+        volume["metadata"] = m_options.volumeMetadata;
+        if (m_options.compressTraces) {
+            volume["encoding"] = kTraceCodecName;
+        }
+
+        QJsonArray blocks;
+        blocks.append(volume);
+        if (geolocations) {
+            QJsonObject block;
+            block["type"] = "Sample Geolocations";
+            block["name"] = geolocations->name.isEmpty() ? QString("Sample Geolocations")
+                                                         : geolocations->name;
+            block["byteOffset"] = volumeOffset + volumeBytes;
+            block["byteSize"] = geolocationBytes;
+            block["srs"] = geolocations->srs;
+            blocks.append(block);
+        }
+
+        QJsonObject root;
+        root["version"] = version;
+        root["mainDescriptor"] = mainDescriptor;
+        root["dataBlockDescriptors"] = blocks;
+        return QJsonDocument(root).toJson(QJsonDocument::Compact);
+    };
+    qint64 volumeOffset = kPreambleSize;
+    QByteArray jsonHeader = buildHeader(volumeOffset);
+    while (kPreambleSize + jsonHeader.size() != volumeOffset) {
+        volumeOffset = kPreambleSize + jsonHeader.size();
+        jsonHeader = buildHeader(volumeOffset);
+    }
+    if (jsonHeader.size() > 99999999) {
+        qWarning() << "JSON header too large";
+        return false;
+    }
+
+    m_file = std::make_unique<QSaveFile>(m_filePath);
+    if (!m_file->open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open file for writing:" << m_filePath;
+        m_file.reset();
+        return false;
+    }
+
+    // 前导：魔数、MD5 占位符、JSON 头长度，各占一行
+    QByteArray preamble("ogpr\n");
+    preamble.append(QByteArray(32, '0'));
+    preamble.append('\n');
+    preamble.append(QByteArray::number(jsonHeader.size()).rightJustified(8, '0'));
+    preamble.append('\n');
+    if (m_file->write(preamble) != kPreambleSize
+        || !writeHashed(jsonHeader.constData(), jsonHeader.size())) {
+        qWarning() << "Failed to write header:" << m_filePath;
+        abort();
+        return false;
+    }
+    return true;
+}
+
+bool OGPRWriter::writeSlices(const float *voltages, const qint64 sliceCount)
+{
+    if (!isOpen() || sliceCount < 0 || m_writtenSlices + sliceCount > m_slices) {
+        qWarning() << "Too many slices written";
+        return false;
+    }
+    const qint64 sliceSamples = m_samples * m_channels;
+    const qint64 slicesPerChunk = std::max<qint64>(1, kChunkSamples / sliceSamples);
+    const float aAdj = m_options.calibration.aAdj;
+    const float bAdj = m_options.calibration.bAdj;
+
+    // 按电压标定的逆变换量化，超出 int16 范围的值饱和
+    for (qint64 first = 0; first < sliceCount; first += slicesPerChunk) {
+        const qint64 count = std::min(slicesPerChunk, sliceCount - first) * sliceSamples;
+        m_buffer.resize(size_t(count));
+        Eigen::Map<Eigen::Array<int16_t, Eigen::Dynamic, 1>>(m_buffer.data(), count)
+            = (Eigen::Map<const Eigen::ArrayXf>(voltages + first * sliceSamples, count) * aAdj + bAdj)
+                  .round()
+                  .max(-32768.0f)
+                  .min(32767.0f)
+                  .cast<int16_t>();
+        if (!writeSamples(m_buffer.data(), count / sliceSamples)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OGPRWriter::writeSlice(const Eigen::MatrixXf &tScan)
+{
+    if (tScan.rows() != m_samples || tScan.cols() != m_channels) {
+        qWarning() << "Slice shape does not match the volume";
+        return false;
+    }
+    return writeSlices(tScan.data(), 1);
+}
+
+bool OGPRWriter::writeRawSlices(const int16_t *samples, const qint64 sliceCount)
+{
+    if (!isOpen() || sliceCount < 0 || m_writtenSlices + sliceCount > m_slices) {
+        qWarning() << "Too many slices written";
+        return false;
+    }
+    // 与转换后的写入保持同样的批大小
+    const qint64 sliceSamples = m_samples * m_channels;
+    const qint64 slicesPerChunk = std::max<qint64>(1, kChunkSamples / sliceSamples);
+    for (qint64 first = 0; first < sliceCount; first += slicesPerChunk) {
+        if (!writeSamples(samples + first * sliceSamples, std::min(slicesPerChunk, sliceCount - first))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool OGPRWriter::writeSamples(const int16_t *samples, const qint64 sliceCount)
+{
+    const qint64 sliceSamples = m_samples * m_channels;
+    if (!m_spool) {
+        const qint64 bytes = sliceCount * sliceSamples * qint64(sizeof(int16_t));
+        if (!writeHashed(reinterpret_cast<const char *>(samples), bytes)) {
+            return false;
+        }
+        m_writtenSlices += sliceCount;
+        return true;
+    }
+
+    // 按切片并行编码到各自的槽位，再按顺序写入临时文件
+    const qint64 slotBytes = maxEncodedSliceBytes(sliceSamples);
+    m_encoded.resize(size_t(sliceCount * slotBytes));
+    std::vector<qint64> encodedBytes(sliceCount);
+    ParallelScheduler::instance().parallelFor(
+        0, sliceCount, kEncodeSliceGrain, [&](const qint64 first, const qint64 last) {
+            for (qint64 slice = first; slice < last; ++slice) {
+                encodedBytes[slice] = encodeSlice(
+                    samples + slice * sliceSamples, sliceSamples, m_encoded.data() + slice * slotBytes);
+            }
+        });
+    for (qint64 slice = 0; slice < sliceCount; ++slice) {
+        const char *data = reinterpret_cast<const char *>(m_encoded.data() + slice * slotBytes);
+        if (m_spool->write(data, encodedBytes[slice]) != encodedBytes[slice]) {
+            qWarning() << "Failed to write compressed slices";
+            return false;
+        }
+        m_offsets.push_back(m_offsets.back() + quint64(encodedBytes[slice]));
+    }
+    m_writtenSlices += sliceCount;
+    return true;
+}
+
+bool OGPRWriter::writeEncodedVolume()
+{
+    const qint64 tableBytes = qint64(m_offsets.size() * sizeof(quint64));
+    if (!writeHeader(tableBytes + qint64(m_offsets.back()))
+        || !writeHashed(reinterpret_cast<const char *>(m_offsets.data()), tableBytes)
+        || !m_spool->flush() || !m_spool->seek(0)) {
+        return false;
+    }
+    QByteArray buffer(kChunkSamples * qint64(sizeof(int16_t)), Qt::Uninitialized);
+    for (qint64 remaining = qint64(m_offsets.back()); remaining > 0;) {
+        const qint64 bytes = std::min<qint64>(buffer.size(), remaining);
+        if (m_spool->read(buffer.data(), bytes) != bytes || !writeHashed(buffer.constData(), bytes)) {
+            qWarning() << "Failed to copy compressed slices";
+            return false;
+        }
+        remaining -= bytes;
+    }
+    m_spool.reset();
+    return true;
+}
+
+bool OGPRWriter::close()
+{
+    if (!isOpen()) {
+        return false;
+    }
+    if (m_writtenSlices != m_slices) {
+        qWarning() << "Incomplete volume:" << m_writtenSlices << "of" << m_slices << "slices written";
+        abort();
+        return false;
+    }
+    if (m_spool && !writeEncodedVolume()) {
+        abort();
+        return false;
+    }
+    if (m_options.geolocations && !writeGeolocations(*m_options.geolocations)) {
+        abort();
+        return false;
+    }
+
+    // 结尾写入 MD5，再回填前导中的占位符
+    const QByteArray digest = m_hash.result().toHex();
+    if (m_file->write(QByteArray("\n") + digest) != 33 || !m_file->seek(5)
+        || m_file->write(digest) != 32 || !m_file->commit()) {
+        qWarning() << "Failed to finish file:" << m_file->fileName();
+        abort();
+        return false;
+    }
+    m_md5 = QString::fromLatin1(digest);
+    m_file.reset();
+    m_options.geolocations = nullptr;
+    return true;
+}
+
+void OGPRWriter::abort()
+{
+    if (m_file) {
+        m_file->cancelWriting();
+        m_file.reset();
+    }
+    m_spool.reset();
+    m_offsets.clear();
+    m_encoded.clear();
+    m_encoded.shrink_to_fit();
+    m_options.geolocations = nullptr;
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+}
+
+bool OGPRWriter::isOpen() const
+{
+    return m_file != nullptr || m_spool != nullptr;
+}
+
+qint64 OGPRWriter::writtenSlices() const
+{
+    return m_writtenSlices;
+}
+
+QString OGPRWriter::md5() const
+{
+    return m_md5;
+}
+
+bool OGPRWriter::writeVolume(const QString &filePath,
+                             const Eigen::Tensor<float, 3> &volume,
+                             const OGPRWriterOptions &options)
+{
+    OGPRWriter writer;
+    return writer.open(filePath, volume.dimension(0), volume.dimension(1), volume.dimension(2), options)
+           && writer.writeSlices(volume.data(), volume.dimension(2)) && writer.close();
+}
+
+bool OGPRWriter::writeHashed(const char *data, const qint64 bytes)
+{
+    if (m_file->write(data, bytes) != bytes) {
+        qWarning() << "Failed to write data block:" << m_file->fileName();
+        return false;
+    }
+    m_hash.addData(QByteArrayView(data, bytes));
+    return true;
+}
+
+bool OGPRWriter::writeGeolocations(const SampleGeolocations &geolocations)
+{
+    constexpr qint64 coordsPerSweep = 2 * 4;
+    // open 之后调用方仍可能修改坐标，写出前再核对一次
+    if (geolocations.sliceIds.size() != m_slices || !hasSweepCount(geolocations.shallow, m_slices * m_channels)
+        || !hasSweepCount(geolocations.deep, m_slices * m_channels)) {
+        qWarning() << "Sample geolocations do not match the volume shape";
+        return false;
+    }
+    const qint64 sliceBytes = geolocationSliceBytes(m_channels);
+    const qint64 slicesPerChunk = std::max<qint64>(1, kChunkSamples * qint64(sizeof(int16_t)) / sliceBytes);
+    QByteArray buffer;
+
+    for (qint64 first = 0; first < m_slices; first += slicesPerChunk) {
+        const qint64 count = std::min(slicesPerChunk, m_slices - first);
+        buffer.resize(count * sliceBytes);
+        char *out = buffer.data();
+        for (qint64 slice = first; slice < first + count; ++slice) {
+            const int64_t sliceId = geolocations.sliceIds[slice];
+            std::memcpy(out, &sliceId, sizeof(sliceId));
+            out += sizeof(sliceId);
+            for (qint64 channel = 0; channel < m_channels; ++channel) {
+                const qsizetype index = geolocations.sweepIndex(slice, channel);
+                const double coords[coordsPerSweep] = {
+                    geolocations.shallow.x[index],
+                    geolocations.shallow.y[index],
+                    geolocations.shallow.depth[index],
+                    geolocations.shallow.elevation[index],
+                    geolocations.deep.x[index],
+                    geolocations.deep.y[index],
+                    geolocations.deep.depth[index],
+                    geolocations.deep.elevation[index],
+                };
+                std::memcpy(out, coords, sizeof(coords));
+                out += sizeof(coords);
+            }
+        }
+        if (!writeHashed(buffer.constData(), buffer.size())) {
+            return false;
+        }
+    }
+    return true;
+}
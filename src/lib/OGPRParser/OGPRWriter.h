@@ -0,0 +1,107 @@
+#ifndef OGPRWRITER_H
+#define OGPRWRITER_H
+
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QString>
+#include <QTemporaryFile>
+#include <memory>
+#include <vector>
+#include "OGPRParser.h"
+
+struct OGPRWriterOptions {
+    int majorVersion = 1;
+    int minorVersion = 0;
+    QJsonObject metadata;       // 主描述符的 metadata
+    QString volumeName = "Radar Volume";
+    QJsonObject radar;          // 雷达数据块的 radar 对象（RadarInfo 字段）
+    QJsonObject volumeMetadata; // 雷达数据块的 metadata
+    // 电压值写回 int16 时使用的标定系数：digital = voltage * aAdj + bAdj，超出范围时饱和
+    VoltageCalibration calibration = VoltageCalibration::fromDigitalRange();
+    // 非空时在雷达数据块之后写入地理定位块，尺寸须与数据体一致，在 close 之前保持有效
+    const SampleGeolocations *geolocations = nullptr;
+    // 以 TraceCodec 无损压缩雷达数据块。压缩后的大小事先未知，切片先写入临时文件，
+    // close 时再与 JSON 头一起写出目标文件
+    bool compressTraces = false;
+};
+
+// 逐切片流式写出 .ogpr 文件，内存占用只有一个转换缓冲区。
+// 前导中的 MD5 先写占位符，数据块写入时同步计算 MD5（范围与 OGPRParser 校验的相同：
+// JSON 头与全部数据块），close 时写入结尾并回填前导，整个数据只写一遍。
+// 先写入临时文件，close 成功后才替换目标文件
+class OGPRWriter
+{
+public:
+    OGPRWriter() = default;
+    ~OGPRWriter();
+
+    OGPRWriter(const OGPRWriter &) = delete;
+    OGPRWriter &operator=(const OGPRWriter &) = delete;
+
+    // 写入前导与 JSON 头，之后按采集顺序写入 slicesCount 个切片
+    bool open(const QString &filePath,
+              qint64 samplesCount,
+              qint64 channelsCount,
+              qint64 slicesCount,
+              const OGPRWriterOptions &options = {});
+
+    // 写入 sliceCount 个连续切片的电压值，列优先 (samples, channels, sliceCount)
+    bool writeSlices(const float *voltages, qint64 sliceCount);
+
+    // 写入一个切片的 TScan：(samples, channels)
+    bool writeSlice(const Eigen::MatrixXf &tScan);
+
+    // 直接写入原始 int16 采样，不做转换
+    bool writeRawSlices(const int16_t *samples, qint64 sliceCount);
+
+    // 全部切片写完后写入地理定位块与结尾，回填 MD5 并替换目标文件
+    bool close();
+
+    // 放弃写入，目标文件保持不变
+    void abort();
+
+    bool isOpen() const;
+
+    qint64 writtenSlices() const;
+
+    // 写入完成后的负载 MD5（小写十六进制）
+    QString md5() const;
+
+    // 一次写出完整的电压数据体 (samples, channels, slices)
+    static bool writeVolume(const QString &filePath,
+                            const Eigen::Tensor<float, 3> &volume,
+                            const OGPRWriterOptions &options = {});
+
+private:
+    // 创建目标文件，写入前导与 JSON 头
+    bool writeHeader(qint64 volumeBytes);
+
+    // 写入 sliceCount 个切片的 int16 采样，压缩模式下编码后写入临时文件
+    bool writeSamples(const int16_t *samples, qint64 sliceCount);
+
+    // 压缩模式：写出偏移表并从临时文件拷贝压缩切片
+    bool writeEncodedVolume();
+
+    // 写入并计入 MD5
+    bool writeHashed(const char *data, qint64 bytes);
+
+    bool writeGeolocations(const SampleGeolocations &geolocations);
+
+    QString m_filePath;
+    std::unique_ptr<QSaveFile> m_file;
+    std::unique_ptr<QTemporaryFile> m_spool;
+    std::vector<quint64> m_offsets;
+    std::vector<uchar> m_encoded;
+    QCryptographicHash m_hash{QCryptographicHash::Md5};
+    OGPRWriterOptions m_options;
+    qint64 m_samples = 0;
+    qint64 m_channels = 0;
+    qint64 m_slices = 0;
+    qint64 m_writtenSlices = 0;
+    std::vector<int16_t> m_buffer;
+    QString m_md5;
+};
+
+#endif // OGPRWRITER_H
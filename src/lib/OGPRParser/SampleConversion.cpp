@@ -0,0 +1,169 @@
+#include "SampleConversion.h"
+#include "ParallelScheduler.h"
+#include "VolumeStorage.h"
+#include <algorithm>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OGPR_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define OGPR_TARGET_AVX2
+#else
+#define OGPR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+using ConvertKernel = void (*)(const int16_t *, float *, std::int64_t, float, float);
+
+// 标量实现：voltage = digital * scale + offset
+void convertScalar(
+    const int16_t *src, float *dst, const std::int64_t count, const float scale, const float offset)
+{
+    for (std::int64_t i = 0; i < count; ++i) {
+        dst[i] = float(src[i]) * scale + offset;
+    }
+}
+
+#ifdef OGPR_X86_64
+// SSE2 实现：x86-64 基线指令集，每次处理 8 个采样
+void convertSse2(
+    const int16_t *src, float *dst, const std::int64_t count, const float scale, const float offset)
+{
+    const __m128 vScale = _mm_set1_ps(scale);
+    const __m128 vOffset = _mm_set1_ps(offset);
+    std::int64_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        // 把 int16 放到 32 位的高半部分后算术右移，完成符号扩展
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(raw, raw), 16);
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), vScale), vOffset));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), vScale), vOffset));
+    }
+    convertScalar(src + i, dst + i, count - i, scale, offset);
+}
+
+// AVX2 实现：每次处理 16 个采样
+OGPR_TARGET_AVX2 void convertAvx2(
+    const int16_t *src, float *dst, const std::int64_t count, const float scale, const float offset)
+{
+    const __m256 vScale = _mm256_set1_ps(scale);
+    const __m256 vOffset = _mm256_set1_ps(offset);
+    std::int64_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m128i rawLo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        const __m128i rawHi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8));
+        const __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(rawLo));
+        const __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(rawHi));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(lo, vScale), vOffset));
+        _mm256_storeu_ps(dst + i + 8, _mm256_add_ps(_mm256_mul_ps(hi, vScale), vOffset));
+    }
+    convertScalar(src + i, dst + i, count - i, scale, offset);
+}
+
+bool cpuSupportsAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    // OSXSAVE 与 AVX，并确认操作系统保存了 YMM 寄存器状态
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+struct SelectedKernel {
+    ConvertKernel kernel;
+    const char *name;
+};
+
+const SelectedKernel &selectedKernel()
+{
+    static const SelectedKernel selected = []() -> SelectedKernel {
+#ifdef OGPR_X86_64
+        if (cpuSupportsAvx2()) {
+            return {convertAvx2, "avx2"};
+        }
+        return {convertSse2, "sse2"};
+#else
+        return {convertScalar, "scalar"};
+#endif
+    }();
+    return selected;
+}
+
+} // namespace
+
+void convertSamplesToVoltage(
+    const int16_t *src, float *dst, const std::int64_t count, const VoltageCalibration &calibration)
+{
+    // (d - b) / a == d * (1 / a) - b / a
+    const float scale = 1.0f / calibration.aAdj;
+    const float offset = -calibration.bAdj / calibration.aAdj;
+    selectedKernel().kernel(src, dst, count, scale, offset);
+}
+
+bool convertSamplesToVoltageWith(const char *kernelName,
+                                 const int16_t *src,
+                                 float *dst,
+                                 const std::int64_t count,
+                                 const VoltageCalibration &calibration)
+{
+    const std::string_view name(kernelName ? kernelName : "");
+    ConvertKernel kernel = nullptr;
+    if (name == "scalar") {
+        kernel = convertScalar;
+    }
+#ifdef OGPR_X86_64
+    if (name == "sse2") {
+        kernel = convertSse2;
+    } else if (name == "avx2" && cpuSupportsAvx2()) {
+        kernel = convertAvx2;
+    }
+#endif
+    if (!kernel) {
+        return false;
+    }
+    kernel(src, dst, count, 1.0f / calibration.aAdj, -calibration.bAdj / calibration.aAdj);
+    return true;
+}
+
+void convertSlicesToVoltage(
+    const int16_t *src,
+    float *dst,
+    const std::int64_t sliceSamples,
+    const std::int64_t slicesCount,
+    const VoltageCalibration &calibration)
+{
+    // 每个任务至少转换 64K 个采样，避免小切片时调度开销占主导
+    constexpr std::int64_t minSamplesPerTask = 64 * 1024;
+    const std::int64_t slicesPerTask
+        = std::max<std::int64_t>(1, minSamplesPerTask / std::max<std::int64_t>(1, sliceSamples));
+
+    ParallelScheduler::instance().parallelFor(
+        0, slicesCount, slicesPerTask, [&](const std::int64_t first, const std::int64_t last) {
+            convertSamplesToVoltage(
+                src + first * sliceSamples, dst + first * sliceSamples, (last - first) * sliceSamples, calibration);
+        });
+}
+
+const char *sampleConversionKernelName()
+{
+    return selectedKernel().name;
+}
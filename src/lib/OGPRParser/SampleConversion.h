@@ -0,0 +1,31 @@
+#ifndef SAMPLECONVERSION_H
+#define SAMPLECONVERSION_H
+
+#include <cstdint>
+
+struct VoltageCalibration;
+
+// int16 采样到电压值的批量转换：dst[i] = (src[i] - bAdj) / aAdj
+// 比例与截距只计算一次，内核在运行时按 CPU 能力选择 AVX2 / SSE2 / 标量实现
+void convertSamplesToVoltage(
+    const int16_t *src, float *dst, std::int64_t count, const VoltageCalibration &calibration);
+
+// 按切片并行转换 slicesCount 个连续切片，每个切片 sliceSamples 个采样
+void convertSlicesToVoltage(
+    const int16_t *src,
+    float *dst,
+    std::int64_t sliceSamples,
+    std::int64_t slicesCount,
+    const VoltageCalibration &calibration);
+
+// 当前使用的内核名称（"avx2"、"sse2" 或 "scalar"），便于日志与性能对比
+const char *sampleConversionKernelName();
+
+// 用指定名称的内核转换，用于基准测试与结果对比；该内核不存在或 CPU 不支持时返回 false
+bool convertSamplesToVoltageWith(const char *kernelName,
+                                 const int16_t *src,
+                                 float *dst,
+                                 std::int64_t count,
+                                 const VoltageCalibration &calibration);
+
+#endif // SAMPLECONVERSION_H
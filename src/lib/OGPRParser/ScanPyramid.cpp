@@ -0,0 +1,147 @@
+#include "ScanPyramid.h"
+#include "ParallelScheduler.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// 第 1 层每个并行区间合并的迹线数，区间内复用两个切片缓冲区
+constexpr std::int64_t kFirstLevelGrain = 8;
+// 之后各层每个并行区间合并的 (通道, 迹线) 数
+constexpr std::int64_t kLevelGrain = 256;
+
+// 两条迹线合并为一条
+void reducePair(const float *a,
+                const float *b,
+                float *dst,
+                const Eigen::Index count,
+                const ScanPyramid::Reduction reduction)
+{
+    const Eigen::Map<const Eigen::ArrayXf> first(a, count);
+    const Eigen::Map<const Eigen::ArrayXf> second(b, count);
+    Eigen::Map<Eigen::ArrayXf> out(dst, count);
+    if (reduction == ScanPyramid::Reduction::MaxAbs) {
+        out = (first.abs() >= second.abs()).select(first, second);
+    } else {
+        out = (first + second) * 0.5f;
+    }
+}
+
+} // namespace
+
+void ScanPyramid::build(const Index samples,
+                        const Index channels,
+                        const Index slices,
+                        const TScanReader &readTScan,
+                        const Reduction reduction,
+                        const Index minTraces)
+{
+    clear();
+    if (samples <= 0 || channels <= 0 || slices <= std::max<Index>(1, minTraces)) {
+        return;
+    }
+    m_samples = samples;
+    m_channels = channels;
+    m_slices = slices;
+    m_reduction = reduction;
+
+    // 第 1 层直接由原始切片两两合并：按迹线并行，每个线程只缓存两个切片
+    Index traces = (slices + 1) / 2;
+    Eigen::Tensor<float, 3> first(samples, traces, channels);
+    ParallelScheduler::instance().parallelFor(
+        0, traces, kFirstLevelGrain, [&](const Index firstTrace, const Index lastTrace) {
+            Eigen::MatrixXf even;
+            Eigen::MatrixXf odd;
+            for (Index j = firstTrace; j < lastTrace; ++j) {
+                readTScan(2 * j, even);
+                const bool paired = 2 * j + 1 < slices;
+                if (paired) {
+                    readTScan(2 * j + 1, odd);
+                }
+                for (Index c = 0; c < channels; ++c) {
+                    float *dst = first.data() + (c * traces + j) * samples;
+                    if (paired) {
+                        reducePair(even.col(c).data(), odd.col(c).data(), dst, samples, reduction);
+                    } else {
+                        std::copy_n(even.col(c).data(), samples, dst);
+                    }
+                }
+            }
+        });
+    m_levels.push_back(std::move(first));
+
+    // 之后每层由上一层合并，按 (通道, 迹线) 并行
+    while (traces > minTraces && traces > 1) {
+        const Index nextTraces = (traces + 1) / 2;
+        Eigen::Tensor<float, 3> next(samples, nextTraces, channels);
+        const float *prev = m_levels.back().data();
+        ParallelScheduler::instance().parallelFor(
+            0, channels * nextTraces, kLevelGrain, [&](const Index firstPair, const Index lastPair) {
+                for (Index k = firstPair; k < lastPair; ++k) {
+                    const Index c = k / nextTraces;
+                    const Index j = k % nextTraces;
+                    const float *src = prev + (c * traces + 2 * j) * samples;
+                    float *dst = next.data() + k * samples;
+                    if (2 * j + 1 < traces) {
+                        reducePair(src, src + samples, dst, samples, reduction);
+                    } else {
+                        std::copy_n(src, samples, dst);
+                    }
+                }
+            });
+        m_levels.push_back(std::move(next));
+        traces = nextTraces;
+    }
+}
+
+void ScanPyramid::clear()
+{
+    m_samples = m_channels = m_slices = 0;
+    m_levels.clear();
+}
+
+bool ScanPyramid::isEmpty() const
+{
+    return m_levels.empty();
+}
+
+ScanPyramid::Reduction ScanPyramid::reduction() const
+{
+    return m_reduction;
+}
+
+int ScanPyramid::levelsCount() const
+{
+    return int(m_levels.size()) + 1;
+}
+
+ScanPyramid::Index ScanPyramid::tracesCount(const int level) const
+{
+    if (level < 0 || level >= levelsCount()) {
+        throw std::out_of_range("Invalid pyramid level");
+    }
+    return level == 0 ? m_slices : m_levels[level - 1].dimension(1);
+}
+
+int ScanPyramid::levelForWidth(const Index width) const
+{
+    for (int level = levelsCount() - 1; level > 0; --level) {
+        if (tracesCount(level) >= width) {
+            return level;
+        }
+    }
+    return 0;
+}
+
+ScanPyramid::BScanMap ScanPyramid::bScan(const int level, const Index channelIndex) const
+{
+    if (level < 1 || level >= levelsCount()) {
+        throw std::out_of_range("Invalid pyramid level");
+    }
+    if (channelIndex < 0 || channelIndex >= m_channels) {
+        throw std::out_of_range("Invalid channel index");
+    }
+    const auto &data = m_levels[level - 1];
+    const Index traces = data.dimension(1);
+    return BScanMap(data.data() + channelIndex * traces * m_samples, m_samples, traces);
+}
@@ -0,0 +1,62 @@
+#ifndef SCANPYRAMID_H
+#define SCANPYRAMID_H
+
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <Eigen/Dense>
+#include <functional>
+#include <vector>
+
+// 沿行进方向（切片）逐级减半的概览金字塔，用于长测线的 BScan 概览。
+// 第 0 层即原始数据，不在此保存；第 k 层每条迹线由第 k - 1 层相邻两条迹线合并而来，
+// 代表 2^k 个原始切片。每层按 (samples, traces, channels) 列优先存储，
+// 单个通道的 BScan 在内存中连续
+class ScanPyramid
+{
+public:
+    using Index = Eigen::Index;
+    using BScanMap = Eigen::Map<const Eigen::MatrixXf>;
+    // 读取单个切片的 TScan：(samples, channels)，会被多个线程同时调用
+    using TScanReader = std::function<void(Index sliceIndex, Eigen::MatrixXf &out)>;
+
+    enum class Reduction {
+        MaxAbs, // 保留绝对值较大的样本（含符号），不削弱窄反射
+        Mean    // 面积平均
+    };
+
+    ScanPyramid() = default;
+
+    // 构建第 1 层起的全部层级，直到迹线数不大于 minTraces
+    void build(Index samples,
+               Index channels,
+               Index slices,
+               const TScanReader &readTScan,
+               Reduction reduction = Reduction::MaxAbs,
+               Index minTraces = 256);
+
+    void clear();
+
+    bool isEmpty() const;
+
+    Reduction reduction() const;
+
+    // 层数，包含第 0 层
+    int levelsCount() const;
+
+    // 指定层的迹线数
+    Index tracesCount(int level) const;
+
+    // 迹线数不少于 width 的最粗一层，未构建时为 0
+    int levelForWidth(Index width) const;
+
+    // 第 level (>= 1) 层通道 channelIndex 的 BScan：(samples, traces)
+    BScanMap bScan(int level, Index channelIndex) const;
+
+private:
+    Index m_samples = 0;
+    Index m_channels = 0;
+    Index m_slices = 0;
+    Reduction m_reduction = Reduction::MaxAbs;
+    std::vector<Eigen::Tensor<float, 3>> m_levels; // m_levels[k - 1] 为第 k 层
+};
+
+#endif // SCANPYRAMID_H
@@ -0,0 +1,161 @@
+#include "TraceCodec.h"
+#include "ParallelScheduler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace {
+
+constexpr std::int64_t kGroupSize = 128;
+// int16 差分经 zigzag 后最多 17 位
+constexpr int kMaxWidth = 17;
+constexpr std::int64_t kTailPadding = 8;
+// 每个并行区间编解码的切片数，切片压缩后长度不一，区间取小以便均衡
+constexpr std::int64_t kSliceGrain = 4;
+
+inline std::uint32_t zigzag(const std::int32_t value)
+{
+    return (std::uint32_t(value) << 1) ^ std::uint32_t(value >> 31);
+}
+
+inline std::int32_t unzigzag(const std::uint32_t value)
+{
+    return std::int32_t(value >> 1) ^ -std::int32_t(value & 1);
+}
+
+inline int bitWidth(std::uint32_t value)
+{
+    int width = 0;
+    while (value) {
+        ++width;
+        value >>= 1;
+    }
+    return width;
+}
+
+// 小端整字读取
+inline std::uint64_t load64(const std::uint8_t *src)
+{
+    std::uint64_t value;
+    std::memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+std::int64_t groupBytes(const std::int64_t count, const int width)
+{
+    return (count * width + 7) / 8;
+}
+
+} // namespace
+
+std::int64_t maxEncodedSliceBytes(const std::int64_t sliceSamples)
+{
+    const std::int64_t groups = (sliceSamples + kGroupSize - 1) / kGroupSize;
+    return groups + groupBytes(sliceSamples, kMaxWidth) + groups + kTailPadding;
+}
+
+std::int64_t encodeSlice(const int16_t *src, const std::int64_t sliceSamples, std::uint8_t *dst)
+{
+    std::int64_t pos = 0;
+    std::int32_t prev = 0;
+    std::uint32_t values[kGroupSize];
+
+    for (std::int64_t first = 0; first < sliceSamples; first += kGroupSize) {
+        const std::int64_t count = std::min(kGroupSize, sliceSamples - first);
+        std::uint32_t maxValue = 0;
+        for (std::int64_t i = 0; i < count; ++i) {
+            const std::int32_t sample = src[first + i];
+            values[i] = zigzag(sample - prev);
+            maxValue |= values[i];
+            prev = sample;
+        }
+        const int width = bitWidth(maxValue);
+        dst[pos++] = std::uint8_t(width);
+        if (width == 0) {
+            continue;
+        }
+
+        std::uint64_t acc = 0;
+        int bits = 0;
+        for (std::int64_t i = 0; i < count; ++i) {
+            acc |= std::uint64_t(values[i]) << bits;
+            bits += width;
+            while (bits >= 8) {
+                dst[pos++] = std::uint8_t(acc);
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        if (bits > 0) {
+            dst[pos++] = std::uint8_t(acc);
+        }
+    }
+
+    std::memset(dst + pos, 0, kTailPadding);
+    return pos + kTailPadding;
+}
+
+bool decodeSlice(const std::uint8_t *src, const std::int64_t srcBytes, int16_t *dst, const std::int64_t sliceSamples)
+{
+    std::int64_t pos = 0;
+    std::int32_t prev = 0;
+
+    for (std::int64_t first = 0; first < sliceSamples; first += kGroupSize) {
+        const std::int64_t count = std::min(kGroupSize, sliceSamples - first);
+        if (pos >= srcBytes) {
+            return false;
+        }
+        const int width = src[pos++];
+        if (width > kMaxWidth) {
+            return false;
+        }
+        const std::int64_t bytes = groupBytes(count, width);
+        // 整字读取最多越过组末尾 7 个字节，由切片末尾的填充保证
+        if (pos + bytes + kTailPadding > srcBytes) {
+            return false;
+        }
+
+        int16_t *out = dst + first;
+        if (width == 0) {
+            std::fill(out, out + count, int16_t(prev));
+            continue;
+        }
+        const std::uint8_t *group = src + pos;
+        const std::uint64_t mask = (std::uint64_t(1) << width) - 1;
+        for (std::int64_t i = 0; i < count; ++i) {
+            const std::int64_t bit = i * width;
+            const auto value = std::uint32_t((load64(group + (bit >> 3)) >> (bit & 7)) & mask);
+            // 差分至多 17 位，prev 始终在 int16 范围内时相加不会溢出；越界说明数据已损坏
+            prev += unzigzag(value);
+            if (prev < INT16_MIN || prev > INT16_MAX) {
+                return false;
+            }
+            out[i] = int16_t(prev);
+        }
+        pos += bytes;
+    }
+    return true;
+}
+
+bool decodeSlices(const std::uint8_t *src,
+                  const std::uint64_t *offsets,
+                  int16_t *dst,
+                  const std::int64_t sliceSamples,
+                  const std::int64_t slicesCount)
+{
+    std::atomic_bool ok{true};
+
+    ParallelScheduler::instance().parallelFor(
+        0, slicesCount, kSliceGrain, [&](const std::int64_t first, const std::int64_t last) {
+            for (std::int64_t slice = first; slice < last; ++slice) {
+                if (offsets[slice + 1] < offsets[slice]
+                    || !decodeSlice(src + (offsets[slice] - offsets[0]),
+                                    std::int64_t(offsets[slice + 1] - offsets[slice]),
+                                    dst + slice * sliceSamples,
+                                    sliceSamples)) {
+                    ok = false;
+                }
+            }
+        });
+    return ok;
+}
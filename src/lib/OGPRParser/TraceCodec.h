@@ -0,0 +1,30 @@
+#ifndef TRACECODEC_H
+#define TRACECODEC_H
+
+#include <cstdint>
+
+// 雷达数据块的无损压缩编码：每个切片独立编码，可随机访问、按切片并行解码。
+// 切片内的 int16 采样按存储顺序做差分，差值经 zigzag 映射为无符号数，
+// 每 128 个值为一组，按组内最大值的位宽紧凑打包（1 字节位宽 + 打包数据），
+// 切片末尾补 8 个零字节，解码时可以整字读取。
+// 数据块布局：slicesCount + 1 个 uint64 偏移（相对偏移表之后，小端），随后依次为各切片
+inline constexpr const char *kTraceCodecName = "delta-zigzag-bitpack";
+
+// 一个切片编码后的最大字节数
+std::int64_t maxEncodedSliceBytes(std::int64_t sliceSamples);
+
+// 编码一个切片，dst 至少 maxEncodedSliceBytes 字节，返回实际写入的字节数
+std::int64_t encodeSlice(const int16_t *src, std::int64_t sliceSamples, std::uint8_t *dst);
+
+// 解码一个切片，数据不完整或位宽无效时返回 false
+bool decodeSlice(const std::uint8_t *src, std::int64_t srcBytes, int16_t *dst, std::int64_t sliceSamples);
+
+// 按切片并行解码 slicesCount 个连续切片。offsets 共 slicesCount + 1 项，
+// 第 i 个切片位于 src + (offsets[i] - offsets[0])，长度 offsets[i + 1] - offsets[i]
+bool decodeSlices(const std::uint8_t *src,
+                  const std::uint64_t *offsets,
+                  int16_t *dst,
+                  std::int64_t sliceSamples,
+                  std::int64_t slicesCount);
+
+#endif // TRACECODEC_H
@@ -0,0 +1,193 @@
+#ifndef VOLUMESTORAGE_H
+#define VOLUMESTORAGE_H
+
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "SampleConversion.h"
+
+// 数字值到电压值的标定系数：voltage = (digital - bAdj) / aAdj
+struct VoltageCalibration {
+    float aAdj = 1.0f;
+    float bAdj = 0.0f;
+
+    // 根据测量范围与微调参数计算标定系数
+    static VoltageCalibration fromDigitalRange(int D_min_meas = -32768,
+                                               int D_max_meas = 32767,
+                                               float delta_a = 0.0,
+                                               float delta_b = 0.0) {
+        // 理论比例因子
+        const float a = (D_max_meas - D_min_meas) / 40.0;
+        // 理论截距
+        const float b = D_min_meas + 20.0 * a;
+        return {a + delta_a, b + delta_b};
+    }
+
+    float toVoltage(float digital) const {
+        return (digital - bAdj) / aAdj;
+    }
+};
+
+// 按原始采样类型保存的雷达数据体，维度顺序与 RadarVolume::data 相同 (samples, channels, slices)，
+// 列优先存储。既可以拥有数据，也可以是外部内存（如映射页）上的只读视图；
+// 只在提取切片时才转换为电压值
+template<typename Sample>
+class VolumeStorage
+{
+public:
+    using Index = Eigen::Index;
+
+    VolumeStorage() = default;
+
+    // 分配并拥有数据
+    void allocate(Index samples, Index channels, Index slices) {
+        m_owned.resize(samples, channels, slices);
+        m_view = nullptr;
+        setShape(samples, channels, slices);
+    }
+
+    // 引用外部只读内存，调用方保证其生命周期
+    void setView(const Sample *data, Index samples, Index channels, Index slices) {
+        m_owned = Eigen::Tensor<Sample, 3>();
+        m_view = data;
+        setShape(samples, channels, slices);
+    }
+
+    void clear() {
+        m_owned = Eigen::Tensor<Sample, 3>();
+        m_view = nullptr;
+        setShape(0, 0, 0);
+    }
+
+    bool isEmpty() const {
+        return data() == nullptr || m_samples * m_channels * m_slices == 0;
+    }
+
+    bool isView() const {
+        return m_view != nullptr;
+    }
+
+    const Sample *data() const {
+        return m_view ? m_view : m_owned.data();
+    }
+
+    // 仅拥有数据时可写
+    Sample *mutableData() {
+        return m_view ? nullptr : m_owned.data();
+    }
+
+    Index samplesCount() const {
+        return m_samples;
+    }
+
+    Index channelsCount() const {
+        return m_channels;
+    }
+
+    Index slicesCount() const {
+        return m_slices;
+    }
+
+    // 驻留内存中的字节数，视图为 0
+    Index residentBytes() const {
+        return m_owned.size() * Index(sizeof(Sample));
+    }
+
+    const VoltageCalibration &calibration() const {
+        return m_calibration;
+    }
+
+    void setCalibration(const VoltageCalibration &calibration) {
+        m_calibration = calibration;
+    }
+
+    // 获取 BScan 切片（通道方向）：(samples, slices)，slicesCount >= 0 时只取前 slicesCount 个切片
+    void extractBScan(Index channelIndex, Eigen::MatrixXf &out, Index slicesCount = -1) const {
+        checkChannel(channelIndex);
+        const Index slices = slicesCount >= 0 ? std::min(slicesCount, m_slices) : m_slices;
+        out.resize(m_samples, slices);
+        for (Index slice = 0; slice < slices; ++slice) {
+            convert(sweep(slice, channelIndex), out.col(slice).data(), m_samples);
+        }
+    }
+
+    // 获取 BScan 中 [firstSlice, firstSlice + slicesCount) 范围内的道：(samples, slicesCount)，超出范围的部分截去
+    void extractBScanRange(Index channelIndex, Index firstSlice, Index slicesCount, Eigen::MatrixXf &out) const {
+        checkChannel(channelIndex);
+        firstSlice = std::clamp<Index>(firstSlice, 0, m_slices);
+        const Index slices = std::clamp<Index>(slicesCount, 0, m_slices - firstSlice);
+        out.resize(m_samples, slices);
+        for (Index slice = 0; slice < slices; ++slice) {
+            convert(sweep(firstSlice + slice, channelIndex), out.col(slice).data(), m_samples);
+        }
+    }
+
+    // 获取 CScan 切片（深度方向）：(channels, slices)
+    void extractCScan(Index depthIndex, Eigen::MatrixXf &out) const {
+        if (depthIndex < 0 || depthIndex >= m_samples) {
+            throw std::out_of_range("Invalid depth index");
+        }
+        using StridedSamples = Eigen::Map<const SampleArray, 0, Eigen::InnerStride<>>;
+        out.resize(m_channels, m_slices);
+        for (Index slice = 0; slice < m_slices; ++slice) {
+            const StridedSamples raw(
+                sweep(slice, 0) + depthIndex, m_channels, Eigen::InnerStride<>(m_samples));
+            out.col(slice).array() = toVoltage(raw);
+        }
+    }
+
+    // 获取 TScan 切片（行进方向）：(samples, channels)，单个切片在内存中连续
+    void extractTScan(Index sliceIndex, Eigen::MatrixXf &out) const {
+        if (sliceIndex < 0 || sliceIndex >= m_slices) {
+            throw std::out_of_range("Invalid volume index");
+        }
+        out.resize(m_samples, m_channels);
+        convert(sweep(sliceIndex, 0), out.data(), m_samples * m_channels);
+    }
+
+private:
+    using SampleArray = Eigen::Array<Sample, Eigen::Dynamic, 1>;
+
+    void setShape(Index samples, Index channels, Index slices) {
+        m_samples = samples;
+        m_channels = channels;
+        m_slices = slices;
+    }
+
+    // 索引越界时与 OGPRParser 的视图函数一样抛出 std::out_of_range
+    void checkChannel(Index channelIndex) const {
+        if (channelIndex < 0 || channelIndex >= m_channels) {
+            throw std::out_of_range("Invalid channel index");
+        }
+    }
+
+    const Sample *sweep(Index slice, Index channel) const {
+        return data() + (slice * m_channels + channel) * m_samples;
+    }
+
+    template<typename Derived>
+    auto toVoltage(const Eigen::ArrayBase<Derived> &raw) const {
+        return (raw.template cast<float>() - m_calibration.bAdj) / m_calibration.aAdj;
+    }
+
+    void convert(const Sample *src, float *dst, Index count) const {
+        if constexpr (std::is_same_v<Sample, int16_t>) {
+            // int16 走向量化转换内核
+            convertSamplesToVoltage(src, dst, count, m_calibration);
+        } else {
+            Eigen::Map<Eigen::ArrayXf>(dst, count) = toVoltage(
+                Eigen::Map<const SampleArray>(src, count));
+        }
+    }
+
+    Eigen::Tensor<Sample, 3> m_owned;
+    const Sample *m_view = nullptr;
+    Index m_samples = 0;
+    Index m_channels = 0;
+    Index m_slices = 0;
+    VoltageCalibration m_calibration = VoltageCalibration::fromDigitalRange();
+};
+
+#endif // VOLUMESTORAGE_H
@@ -0,0 +1,69 @@
+#include "ParallelScheduler.h"
+#include <omp.h>
+
+namespace {
+
+int processorCount()
+{
+    return std::max(1, omp_get_num_procs());
+}
+
+} // namespace
+
+ParallelScheduler::ParallelScheduler()
+    : m_workers(processorCount())
+    , m_busyCap(std::max(1, processorCount() / 2))
+{}
+
+ParallelScheduler &ParallelScheduler::instance()
+{
+    static ParallelScheduler scheduler;
+    return scheduler;
+}
+
+int ParallelScheduler::workerCount() const
+{
+    return m_workers;
+}
+
+void ParallelScheduler::setWorkerCount(const int workers)
+{
+    m_workers = workers > 0 ? workers : processorCount();
+}
+
+int ParallelScheduler::busyWorkerCap() const
+{
+    return m_busyCap;
+}
+
+void ParallelScheduler::setBusyWorkerCap(const int workers)
+{
+    m_busyCap = std::max(1, workers);
+}
+
+void ParallelScheduler::beginUiBusy()
+{
+    ++m_uiBusy;
+}
+
+void ParallelScheduler::endUiBusy()
+{
+    --m_uiBusy;
+}
+
+bool ParallelScheduler::isUiBusy() const
+{
+    return m_uiBusy > 0;
+}
+
+int ParallelScheduler::threadCount(const std::int64_t chunks) const
+{
+    if (chunks <= 1 || omp_in_parallel()) {
+        return 1;
+    }
+    int threads = m_workers;
+    if (isUiBusy()) {
+        threads = std::min<int>(threads, m_busyCap);
+    }
+    return int(std::min<std::int64_t>(threads, chunks));
+}
@@ -0,0 +1,75 @@
+#ifndef PARALLELSCHEDULER_H
+#define PARALLELSCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+// 处理库共用的并行调度器，所有并行内核通过它决定线程数。
+// 工作线程数默认为处理器核数，可以全局设置；界面线程繁忙时线程数不超过 busyWorkerCap，
+// 给界面留出核心。已经处于并行区域内时（例如按块融合执行的流水线）内核串行执行，不再嵌套
+class ParallelScheduler
+{
+public:
+    static ParallelScheduler &instance();
+
+    int workerCount() const;
+
+    // workers <= 0 时恢复为处理器核数
+    void setWorkerCount(int workers);
+
+    int busyWorkerCap() const;
+
+    void setBusyWorkerCap(int workers);
+
+    // 界面繁忙计数，可以嵌套
+    void beginUiBusy();
+    void endUiBusy();
+    bool isUiBusy() const;
+
+    // 在作用域内标记界面繁忙
+    class UiBusyScope
+    {
+    public:
+        UiBusyScope() { ParallelScheduler::instance().beginUiBusy(); }
+        ~UiBusyScope() { ParallelScheduler::instance().endUiBusy(); }
+        UiBusyScope(const UiBusyScope &) = delete;
+        UiBusyScope &operator=(const UiBusyScope &) = delete;
+    };
+
+    // chunks 个任务块当前可以使用的线程数
+    int threadCount(std::int64_t chunks) const;
+
+    // 把 [begin, end) 切成不超过 grain 的连续区间并行执行 body(first, last)。
+    // grain 由各内核按单个区间的开销设定：区间内可以复用临时缓冲区和累加状态
+    template<typename Body>
+    void parallelFor(std::int64_t begin, std::int64_t end, std::int64_t grain, Body &&body) const
+    {
+        const std::int64_t count = end - begin;
+        if (count <= 0) {
+            return;
+        }
+        grain = std::max<std::int64_t>(1, grain);
+        const std::int64_t chunks = (count + grain - 1) / grain;
+        const int threads = threadCount(chunks);
+        if (threads <= 1) {
+            body(begin, end);
+            return;
+        }
+
+#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+        for (std::int64_t chunk = 0; chunk < chunks; ++chunk) {
+            const std::int64_t first = begin + chunk * grain;
+            body(first, std::min(end, first + grain));
+        }
+    }
+
+private:
+    ParallelScheduler();
+
+    std::atomic_int m_workers;
+    std::atomic_int m_busyCap;
+    std::atomic_int m_uiBusy{0};
+};
+
+#endif // PARALLELSCHEDULER_H
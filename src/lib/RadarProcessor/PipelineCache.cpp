@@ -0,0 +1,114 @@
+#include "PipelineCache.h"
+#include "RadarPipeline.h"
+#include <vector>
+
+namespace {
+
+qint64 scanBytes(const Eigen::MatrixXf &scan)
+{
+    return qint64(scan.size()) * qint64(sizeof(float));
+}
+
+} // namespace
+
+PipelineCache::PipelineCache(const qint64 maxBytes)
+    : m_maxBytes(maxBytes)
+{}
+
+qint64 PipelineCache::maxBytes() const
+{
+    return m_maxBytes;
+}
+
+void PipelineCache::setMaxBytes(const qint64 maxBytes)
+{
+    m_maxBytes = maxBytes;
+    evict(0);
+}
+
+qint64 PipelineCache::totalBytes() const
+{
+    return m_totalBytes;
+}
+
+void PipelineCache::clear()
+{
+    m_entries.clear();
+    m_totalBytes = 0;
+    m_lastPrefixes.clear();
+}
+
+void PipelineCache::run(const RadarPipeline &pipeline, Eigen::MatrixXf &scan)
+{
+    const auto &steps = pipeline.steps();
+    std::vector<QString> prefixes;
+    prefixes.reserve(steps.size());
+    QString prefix;
+    for (const auto &step : steps) {
+        prefix += step.key + "/";
+        prefixes.push_back(prefix);
+    }
+
+    // 最长的已缓存前缀
+    size_t firstStep = 0;
+    for (size_t i = steps.size(); i > 0; --i) {
+        const auto it = m_entries.find(prefixes[i - 1]);
+        if (it != m_entries.end()) {
+            it.value().lastUse = ++m_clock;
+            scan = it.value().scan;
+            firstStep = i;
+            break;
+        }
+    }
+
+    // 与上一次执行第一个不同的步骤。交互调参时之后多半还会修改同一步，在它之前留一个检查点，下次从这里继续
+    size_t changedStep = 0;
+    while (changedStep < prefixes.size() && changedStep < m_lastPrefixes.size()
+           && prefixes[changedStep] == m_lastPrefixes[changedStep]) {
+        ++changedStep;
+    }
+    m_lastPrefixes = prefixes;
+
+    // 未命中的步骤分段执行：每个跨道步骤单独一段，连续的逐道步骤融合为一段，与 RadarPipeline::run 相同，
+    // 只在检查点处多断开一次。除检查点外只缓存最终结果，首次执行只比直接执行多一次拷贝
+    for (size_t first = firstStep; first < steps.size();) {
+        size_t last = first + 1;
+        if (steps[first].traceLocal) {
+            while (last < steps.size() && last != changedStep && steps[last].traceLocal) {
+                ++last;
+            }
+        }
+        pipeline.run(scan, first, last);
+        if (last == steps.size() || last == changedStep) {
+            insert(prefixes[last - 1], scan);
+        }
+        first = last;
+    }
+}
+
+void PipelineCache::insert(const QString &key, const Eigen::MatrixXf &scan)
+{
+    const qint64 bytes = scanBytes(scan);
+    if (bytes > m_maxBytes) {
+        return;
+    }
+    evict(bytes);
+    Entry &entry = m_entries[key];
+    m_totalBytes += bytes - scanBytes(entry.scan);
+    entry.scan = scan;
+    entry.lastUse = ++m_clock;
+}
+
+void PipelineCache::evict(const qint64 incomingBytes)
+{
+    while (!m_entries.isEmpty() && m_totalBytes + incomingBytes > m_maxBytes) {
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it.value().lastUse < oldest.value().lastUse) {
+                oldest = it;
+            }
+        }
+        m_totalBytes -= scanBytes(oldest.value().scan);
+        m_entries.erase(oldest);
+    }
+}
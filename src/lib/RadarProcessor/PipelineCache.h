@@ -0,0 +1,51 @@
+#ifndef PIPELINECACHE_H
+#define PIPELINECACHE_H
+
+#include <Eigen/Dense>
+#include <QHash>
+#include <QString>
+#include <vector>
+
+class RadarPipeline;
+
+// 流水线中间结果的缓存，键为步骤前缀（前 i 个步骤的键依次拼接）。
+// 执行时从已缓存的最长前缀的结果继续，只重新计算第一个不同的步骤及其后的步骤，
+// 其余步骤与 RadarPipeline::run 一样融合执行。缓存最终结果，另在与上一次执行不同的第一个步骤之前
+// 留一个检查点，反复调整同一步骤时只重算它及其后的步骤。
+// 总大小超过预算时按最近最少使用淘汰。
+// 缓存只对同一份输入有效，输入改变后需要 clear
+class PipelineCache
+{
+public:
+    explicit PipelineCache(qint64 maxBytes = 512ll * 1024 * 1024);
+
+    qint64 maxBytes() const;
+
+    void setMaxBytes(qint64 maxBytes);
+
+    qint64 totalBytes() const;
+
+    void clear();
+
+    // scan 为流水线的输入，执行后为输出
+    void run(const RadarPipeline &pipeline, Eigen::MatrixXf &scan);
+
+private:
+    struct Entry {
+        Eigen::MatrixXf scan;
+        quint64 lastUse = 0;
+    };
+
+    void insert(const QString &key, const Eigen::MatrixXf &scan);
+
+    // 淘汰最久未使用的条目，直到还能容纳 incomingBytes
+    void evict(qint64 incomingBytes);
+
+    QHash<QString, Entry> m_entries;
+    std::vector<QString> m_lastPrefixes; // 上一次执行的各步骤前缀
+    qint64 m_maxBytes;
+    qint64 m_totalBytes = 0;
+    quint64 m_clock = 0;
+};
+
+#endif // PIPELINECACHE_H
@@ -0,0 +1,275 @@
+#include "RadarKernels.h"
+#include "ParallelScheduler.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+using Eigen::MatrixXf;
+
+namespace {
+
+// 去背景内核按行块并行：每个行块独立地沿迹线扫描全部列，滑动和不需要在块边界重建
+constexpr std::int64_t kWindowMeanRowGrain = 16;
+// 时间窗去背景按道并行，每个区间复用一个前缀和缓冲区
+constexpr std::int64_t kTimeWindowTraceGrain = 64;
+
+// 对 rows [rowStart, rowEnd) 的每一列 i 减去窗口 window(i) = [first, second) 内各列的逐行均值，结果写入 out。
+// 窗口起止随 i 单调不减时只加减进出窗口的列，每列 O(1)；否则重新求和。累加使用 double
+template<typename WindowFn>
+void subtractWindowMeans(const MatrixXf &in, MatrixXf &out, const int rowStart, const int rowEnd, WindowFn window)
+{
+    const int nc = in.cols();
+
+    ParallelScheduler::instance().parallelFor(
+        rowStart, rowEnd, kWindowMeanRowGrain, [&](const std::int64_t firstRow, const std::int64_t lastRow) {
+            const Eigen::Index rows = lastRow - firstRow;
+            Eigen::VectorXd sum = Eigen::VectorXd::Zero(rows);
+            int start = 0;
+            int end = 0;
+            for (int i = 0; i < nc; ++i) {
+                const auto [newStart, newEnd] = window(i);
+                const bool incremental = i > 0 && newStart >= start && newEnd >= end
+                                         && (newStart - start) + (newEnd - end) <= newEnd - newStart;
+                if (!incremental) {
+                    sum.setZero();
+                    start = end = newStart;
+                }
+                for (; end < newEnd; ++end) {
+                    sum += in.col(end).segment(firstRow, rows).cast<double>();
+                }
+                for (; start < newStart; ++start) {
+                    sum -= in.col(start).segment(firstRow, rows).cast<double>();
+                }
+
+                const double count = newEnd - newStart;
+                out.col(i).segment(firstRow, rows)
+                    = (in.col(i).segment(firstRow, rows).cast<double>() - sum / count).cast<float>();
+            }
+        });
+}
+
+} // namespace
+
+void RadarKernels::dewow(Eigen::Ref<Eigen::MatrixXf> traces)
+{
+    // 计算每列的平均值
+    const Eigen::RowVectorXf colMeans = traces.colwise().mean();
+    // 减去每列的平均值
+    traces.rowwise() -= colMeans;
+}
+
+void RadarKernels::startTimeShift(Eigen::Ref<Eigen::MatrixXf> traces, int shift)
+{
+    const int rows = int(traces.rows());
+    shift = std::clamp(shift, -rows, rows);
+    if (shift > 0) {
+        // 向下移动
+        traces.bottomRows(rows - shift) = traces.topRows(rows - shift).eval();
+        traces.topRows(shift).setZero(); // 填充零
+    } else if (shift < 0) {
+        // 向上移动
+        traces.topRows(rows + shift) = traces.bottomRows(rows + shift).eval();
+        traces.bottomRows(-shift).setZero(); // 填充零
+    }
+}
+
+Eigen::ArrayXf RadarKernels::exponentialGainCurve(
+    const Eigen::Index rows, const double scale, const double exponent, const double startTimes, const double lastTimes)
+{
+    // 计算 t_0 和 t_end
+    const double t_0 = std::pow(startTimes, 1.0 / exponent);
+    const double t_end = std::pow(lastTimes, 1.0 / exponent);
+
+    // 创建时间向量 t
+    const Eigen::ArrayXf t = Eigen::ArrayXf::LinSpaced(rows, t_0, t_end);
+    return scale * t.pow(exponent);
+}
+
+void RadarKernels::applyRowGains(Eigen::Ref<Eigen::MatrixXf> traces, const Eigen::ArrayXf &gains)
+{
+    traces.array().colwise() *= gains;
+}
+
+void RadarKernels::removeBackground(Eigen::Ref<Eigen::MatrixXf> traces, int windowSize)
+{
+    const int numTraces = traces.cols();  // 轨迹的数量
+    const int numSamples = traces.rows(); // 每个轨迹的采样点数
+
+    // 确保窗口大小是奇数
+    if (windowSize % 2 == 0) {
+        windowSize += 1; // 如果不是奇数，调整为奇数
+    }
+    if (numSamples == 0 || windowSize <= 0) {
+        return;
+    }
+
+    const int halfWindow = windowSize / 2; // 窗口的一半
+
+    // 窗口 [t - halfWindow, t + halfWindow] 在道首尾截断，每个时间点的实际采样数的倒数
+    const Eigen::ArrayXd sampleIndex = Eigen::ArrayXd::LinSpaced(numSamples, 0, numSamples - 1);
+    const Eigen::ArrayXd inverseCount
+        = 1.0
+          / ((sampleIndex + halfWindow).min(numSamples - 1.0) - (sampleIndex - halfWindow).max(0.0) + 1.0);
+
+    // 逐道处理：沿道累加得到扩展前缀和 prefix[k] = 前 clamp(k - halfWindow, 0, numSamples) 个采样之和，
+    // 于是时间点 t 的窗口和为 prefix[t + windowSize] - prefix[t]，整道一次向量运算完成，原地写回
+    ParallelScheduler::instance().parallelFor(
+        0, numTraces, kTimeWindowTraceGrain, [&](const std::int64_t first, const std::int64_t last) {
+            Eigen::ArrayXd prefix(numSamples + windowSize);
+            for (Eigen::Index i = first; i < last; ++i) {
+                const float *trace = traces.col(i).data();
+                prefix.head(halfWindow + 1).setZero();
+                double sum = 0.0;
+                for (int t = 0; t < numSamples; ++t) {
+                    sum += trace[t];
+                    prefix[halfWindow + 1 + t] = sum;
+                }
+                prefix.tail(halfWindow).setConstant(sum);
+
+                traces.col(i).array()
+                    -= ((prefix.segment(windowSize, numSamples) - prefix.head(numSamples)) * inverseCount)
+                           .cast<float>();
+            }
+        });
+}
+
+void RadarKernels::automaticGainControl(Eigen::Ref<Eigen::MatrixXf> traces, int windowSize)
+{
+    const int numTraces = traces.cols();
+    const int numSamples = traces.rows();
+
+    // 偶数窗口静默调整为奇数，交互处理时每幅图像都会经过这里
+    if (windowSize % 2 == 0) {
+        windowSize += 1;
+    }
+    if (numSamples == 0 || windowSize <= 0) {
+        return;
+    }
+
+    const int halfWindow = windowSize / 2;
+
+    // 与 removeBackground 相同的截断窗口
+    const Eigen::ArrayXd sampleIndex = Eigen::ArrayXd::LinSpaced(numSamples, 0, numSamples - 1);
+    const Eigen::ArrayXd inverseCount
+        = 1.0
+          / ((sampleIndex + halfWindow).min(numSamples - 1.0) - (sampleIndex - halfWindow).max(0.0) + 1.0);
+
+    // 逐道累加平方得到扩展前缀和，窗口均方为 (prefix[t + windowSize] - prefix[t]) / count。
+    // 全零的窗口均方为零，其中的采样保持为零
+    ParallelScheduler::instance().parallelFor(
+        0, numTraces, kTimeWindowTraceGrain, [&](const std::int64_t first, const std::int64_t last) {
+            Eigen::ArrayXd prefix(numSamples + windowSize);
+            Eigen::ArrayXd meanSquare(numSamples);
+            for (Eigen::Index i = first; i < last; ++i) {
+                const float *trace = traces.col(i).data();
+                prefix.head(halfWindow + 1).setZero();
+                double sum = 0.0;
+                for (int t = 0; t < numSamples; ++t) {
+                    sum += double(trace[t]) * trace[t];
+                    prefix[halfWindow + 1 + t] = sum;
+                }
+                prefix.tail(halfWindow).setConstant(sum);
+
+                meanSquare = (prefix.segment(windowSize, numSamples) - prefix.head(numSamples)) * inverseCount;
+                traces.col(i).array() *= (meanSquare > 0.0).select(meanSquare.rsqrt(), 0.0).cast<float>();
+            }
+        });
+}
+
+void RadarKernels::removeDynamicWindowBackground(Eigen::MatrixXf &scan, int dw, int s, int e)
+{
+    const int nr = scan.rows(); // 行数
+    const int nc = scan.cols(); // 列数
+    // 异常处理
+    if (s < 0 || s >= nr || e <= 0 || e > nr) {
+        s = 0;
+        e = nr;
+    }
+    if (dw <= 0 || dw >= nc / 4) {
+        dw = nc / 4;
+    }
+
+    // 动态窗口大小 N，确保为奇数
+    const int N = (dw % 2 != 0) ? dw : dw + 1;
+    const int half = (N - 1) / 2;
+
+    // [s, e) 之外的行保持不变，只拷贝这部分
+    Eigen::MatrixXf rewgb(nr, nc);
+    rewgb.topRows(s) = scan.topRows(s);
+    rewgb.bottomRows(nr - e) = scan.bottomRows(nr - e);
+
+    // 正常窗口以 i 为中心 [i - half, i + half]；左右边缘分别固定为 [0, half) 与 [nc - half, nc)
+    subtractWindowMeans(scan, rewgb, s, e, [nc, half](const int i) {
+        if (i < half) {
+            return std::pair<int, int>(0, half);
+        }
+        if (i >= nc - half) {
+            return std::pair<int, int>(nc - half, nc);
+        }
+        return std::pair<int, int>(i - half, i + half + 1);
+    });
+
+    // 更新矩阵
+    scan.swap(rewgb);
+}
+
+void RadarKernels::adaptiveBackgroundRemoval(Eigen::MatrixXf &scan, const int q)
+{
+    const int N = scan.cols(); // B-SCAN 数据的列数（A-SCAN 的道数）
+    const int M = scan.rows(); // B-SCAN 数据的行数（每道 A-SCAN 的采样点数）
+    if (q <= 0) {
+        qWarning() << "adaptiveBackgroundRemoval: invalid q" << q;
+        return;
+    }
+    const int W = N / q; // 滑动窗口的大小
+    Eigen::MatrixXf B_prime(M, N);
+
+    // 滑动窗口：正常情况为 [i, i + W)，边缘情况窗口大小为 N - i，起点为 i - (N - W)
+    subtractWindowMeans(scan, B_prime, 0, M, [N, W](const int i) {
+        if (i < N - W + 1) {
+            return std::pair<int, int>(i, i + W);
+        }
+        const int windowStart = i - (N - W);
+        return std::pair<int, int>(windowStart, windowStart + N - i);
+    });
+
+    scan.swap(B_prime); // 更新处理后的数据
+}
+
+// 矩阵整体标准化函数
+void RadarKernels::standardizeGlobal(Eigen::Ref<Eigen::MatrixXf> scan)
+{
+    // 计算整个矩阵的均值和标准差
+    const double mean = scan.mean();                                                          // 均值
+    const double stddev = std::sqrt((scan.array() - mean).square().sum() / double(scan.size())); // 标准差
+
+    // 如果标准差为 0，说明所有元素相同，标准化后全部设为 0
+    if (stddev == 0) {
+        scan.setZero();
+    } else {
+        // 标准化：减去均值，除以标准差
+        scan = (scan.array() - mean) / stddev;
+    }
+}
+
+// 行标准化函数：对矩阵的每一行进行标准化
+void RadarKernels::standardizeByRow(Eigen::Ref<Eigen::MatrixXf> scan)
+{
+    const int rows = scan.rows();
+    const int cols = scan.cols();
+
+    // 对每一行进行标准化
+    for (int i = 0; i < rows; ++i) {
+        // 计算当前行的均值和标准差
+        const double mean = scan.row(i).mean();
+        const double stddev = std::sqrt((scan.row(i).array() - mean).square().sum() / cols);
+
+        // 如果标准差为 0，说明该行所有值相同，标准化后全部设为 0
+        if (stddev == 0) {
+            scan.row(i).setZero();
+        } else {
+            // 标准化：减去均值，除以标准差
+            scan.row(i) = (scan.row(i).array() - mean) / stddev;
+        }
+    }
+}
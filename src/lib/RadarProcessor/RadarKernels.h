@@ -0,0 +1,47 @@
+#ifndef RADARKERNELS_H
+#define RADARKERNELS_H
+
+#include <Eigen/Dense>
+
+// RadarProcessor 与 RadarPipeline 共用的处理算法，矩阵每列为一道。
+// 接受 Eigen::Ref 的函数只依赖各道自身的数据，可以对任意一组连续的道分块处理；
+// 接受 Eigen::MatrixXf & 的函数需要跨道的数据，必须作用于整个矩阵
+namespace RadarKernels {
+
+// 每道减去自身均值
+void dewow(Eigen::Ref<Eigen::MatrixXf> traces);
+
+// 沿道平移 shift 个采样，正数向下，空出的位置填零
+void startTimeShift(Eigen::Ref<Eigen::MatrixXf> traces, int shift);
+
+// 指数增益曲线：t 从 startTimes^(1/exponent) 线性变化到 lastTimes^(1/exponent)，增益为 scale * t^exponent
+Eigen::ArrayXf exponentialGainCurve(Eigen::Index rows,
+                                    double scale,
+                                    double exponent,
+                                    double startTimes,
+                                    double lastTimes);
+
+// 每个采样乘以所在行的增益
+void applyRowGains(Eigen::Ref<Eigen::MatrixXf> traces, const Eigen::ArrayXf &gains);
+
+// 每个采样减去所在道内以它为中心、长为 windowSize（取奇数）的时间窗均值，窗口在道首尾截断
+void removeBackground(Eigen::Ref<Eigen::MatrixXf> traces, int windowSize);
+
+// 自动增益控制：每个采样除以所在道内以它为中心、长为 windowSize（取奇数）的时间窗均方根，窗口在道首尾截断
+void automaticGainControl(Eigen::Ref<Eigen::MatrixXf> traces, int windowSize);
+
+// 沿迹线方向的动态窗口去背景，只处理 [s, e) 行
+void removeDynamicWindowBackground(Eigen::MatrixXf &scan, int dw, int s, int e);
+
+// 自适应窗口去背景，窗口为总道数的 1 / q
+void adaptiveBackgroundRemoval(Eigen::MatrixXf &scan, int q);
+
+// 整体标准化为零均值、单位标准差
+void standardizeGlobal(Eigen::Ref<Eigen::MatrixXf> scan);
+
+// 逐行标准化
+void standardizeByRow(Eigen::Ref<Eigen::MatrixXf> scan);
+
+} // namespace RadarKernels
+
+#endif // RADARKERNELS_H
@@ -0,0 +1,306 @@
+#include "RadarPipeline.h"
+#include "RadarKernels.h"
+#include "ParallelScheduler.h"
+#include "TraceFFT.h"
+#include "TraceIIR.h"
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+
+// 融合执行时每个道块的大小，保证一块数据留在 L2 缓存中
+constexpr Eigen::Index kBlockBytes = 256 * 1024;
+
+void runFused(Eigen::MatrixXf &scan, const std::vector<RadarPipeline::TraceKernel> &kernels)
+{
+    const Eigen::Index rows = scan.rows();
+    const Eigen::Index cols = scan.cols();
+    if (rows == 0 || cols == 0) {
+        return;
+    }
+    const Eigen::Index blockCols = std::max<Eigen::Index>(1, kBlockBytes / (rows * Eigen::Index(sizeof(float))));
+    const Eigen::Index blocks = (cols + blockCols - 1) / blockCols;
+
+    // 块内各步骤串行执行；只有一块或只有一个线程时，各步骤内部自行并行
+    ParallelScheduler::instance().parallelFor(
+        0, blocks, 1, [&](const std::int64_t firstBlock, const std::int64_t lastBlock) {
+            for (Eigen::Index block = firstBlock; block < lastBlock; ++block) {
+                const Eigen::Index first = block * blockCols;
+                auto traces = scan.middleCols(first, std::min(blockCols, cols - first));
+                for (const auto &kernel : kernels) {
+                    kernel(traces);
+                }
+            }
+        });
+}
+
+// 步骤名与全部参数，参数按 17 位有效数字格式化，不同的参数值不会得到相同的键
+QString stepKey(const QString &name, std::initializer_list<double> params)
+{
+    QString key = name + "_";
+    for (const double param : params) {
+        key += QString::number(param, 'g', 17) + ",";
+    }
+    return key;
+}
+
+} // namespace
+
+RadarPipeline &RadarPipeline::dewow()
+{
+    return addTraceStep("DW", {}, [](Eigen::Index) -> TraceKernel {
+        return [](Eigen::Ref<Eigen::MatrixXf> traces) { RadarKernels::dewow(traces); };
+    });
+}
+
+RadarPipeline &RadarPipeline::startTimeShift(const int shift)
+{
+    return addTraceStep("STS", {double(shift)}, [shift](Eigen::Index) -> TraceKernel {
+        return [shift](Eigen::Ref<Eigen::MatrixXf> traces) { RadarKernels::startTimeShift(traces, shift); };
+    });
+}
+
+RadarPipeline &RadarPipeline::exponentialGain(
+    const double scale, const double exponent, const double startTimes, const double lastTimes)
+{
+    return addTraceStep("EG", {scale, exponent, startTimes, lastTimes}, [=](const Eigen::Index samples) -> TraceKernel {
+        const Eigen::ArrayXf gains
+            = RadarKernels::exponentialGainCurve(samples, scale, exponent, startTimes, lastTimes);
+        return [gains](Eigen::Ref<Eigen::MatrixXf> traces) { RadarKernels::applyRowGains(traces, gains); };
+    });
+}
+
+RadarPipeline &RadarPipeline::removeBackground(const int windowSize)
+{
+    return addTraceStep("RB", {double(windowSize)}, [windowSize](Eigen::Index) -> TraceKernel {
+        return [windowSize](Eigen::Ref<Eigen::MatrixXf> traces) {
+            RadarKernels::removeBackground(traces, windowSize);
+        };
+    });
+}
+
+RadarPipeline &RadarPipeline::automaticGainControl(const int windowSize)
+{
+    return addTraceStep("AGC", {double(windowSize)}, [windowSize](Eigen::Index) -> TraceKernel {
+        return [windowSize](Eigen::Ref<Eigen::MatrixXf> traces) {
+            RadarKernels::automaticGainControl(traces, windowSize);
+        };
+    });
+}
+
+RadarPipeline &RadarPipeline::bandpassFilter(
+    const double lowCut, const double highCut, const double samplingRate, const double taperWidth)
+{
+    return addTraceStep("BF", {lowCut, highCut, samplingRate, taperWidth}, [=](const Eigen::Index samples) -> TraceKernel {
+        const Eigen::ArrayXf gains = TraceFFT::bandpassGains(samples, samplingRate, lowCut, highCut, taperWidth);
+        return [gains](Eigen::Ref<Eigen::MatrixXf> traces) { TraceFFT::filterTraces(traces, gains); };
+    });
+}
+
+RadarPipeline &RadarPipeline::butterworthBandpass(
+    const double lowCut, const double highCut, const double samplingRate, const int order)
+{
+    return addTraceStep("IIR", {lowCut, highCut, samplingRate, double(order)}, [=](Eigen::Index) -> TraceKernel {
+        const std::vector<Biquad> sections = TraceIIR::butterworthBandpass(lowCut, highCut, samplingRate, order);
+        return [sections](Eigen::Ref<Eigen::MatrixXf> traces) { TraceIIR::filtfiltTraces(traces, sections); };
+    });
+}
+
+RadarPipeline &RadarPipeline::removeDynamicWindowBackground(const int dw, const int s, const int e)
+{
+    addGlobalStep("BR", {double(dw), double(s), double(e)}, [=](Eigen::MatrixXf &scan) {
+        RadarKernels::removeDynamicWindowBackground(scan, dw, s, e);
+    });
+    // 窗口按整条测线的道数限定，与整体处理时相同
+    const auto globalWindow = [dw](const Eigen::Index traces) {
+        return dw <= 0 || dw >= traces / 4 ? int(traces / 4) : dw;
+    };
+    Step &step = m_steps.back();
+    step.traceHalo = [globalWindow](const Eigen::Index traces) -> Eigen::Index {
+        const int window = globalWindow(traces);
+        return window % 2 != 0 ? (window - 1) / 2 : window / 2;
+    };
+    step.applyTile = [=](Eigen::MatrixXf &tile, const Eigen::Index traces) {
+        RadarKernels::removeDynamicWindowBackground(tile, globalWindow(traces), s, e);
+    };
+    return *this;
+}
+
+RadarPipeline &RadarPipeline::adaptiveBackgroundRemoval(const int q)
+{
+    return addGlobalStep("ABR", {double(q)}, [q](Eigen::MatrixXf &scan) {
+        RadarKernels::adaptiveBackgroundRemoval(scan, q);
+    });
+}
+
+RadarPipeline &RadarPipeline::standardizeGlobal()
+{
+    return addGlobalStep("SG", {}, [](Eigen::MatrixXf &scan) { RadarKernels::standardizeGlobal(scan); });
+}
+
+RadarPipeline &RadarPipeline::standardizeByRow()
+{
+    return addGlobalStep("SR", {}, [](Eigen::MatrixXf &scan) { RadarKernels::standardizeByRow(scan); });
+}
+
+RadarPipeline RadarPipeline::fromMacro(const QString &macro, const int traceStep)
+{
+    RadarPipeline pipeline;
+    const QStringList funcs = macro.split("/");
+    for (int i = 0; i < funcs.length() - 1; i++) {
+        const auto tmp = funcs[i].split("_");
+        const auto &funcName = tmp[0];
+        const auto funcParams = tmp.length() > 1 ? tmp[1].split(",") : QStringList();
+
+        if (funcName == "DW") {
+            pipeline.dewow();
+        } else if (funcName == "STS") {
+            pipeline.startTimeShift(-29);
+        } else if (funcName == "EG") {
+            if (funcParams.length() != 2) {
+                qDebug() << "exponentialGain params error";
+            } else {
+                const auto exponent = funcParams[0].toDouble();
+                const auto exponentScale = funcParams[1].toDouble();
+                pipeline.exponentialGain(exponentScale, exponent, 0, 483);
+            }
+        } else if (funcName == "AGC") {
+            // AGC_window，窗口为采样数
+            if (funcParams.length() != 1) {
+                qDebug() << "automaticGainControl params error";
+            } else {
+                pipeline.automaticGainControl(funcParams[0].toInt());
+            }
+        } else if (funcName == "BR") {
+            if (funcParams.length() != 1) {
+                qDebug() << "removeDynamicWindowBackground params error";
+            } else {
+                // 窗口按原始切片数给出，概览层级上换算为迹线数，至少保留 3 道以免每道减去自身；
+                // dw <= 0 保持不变，由算法取默认窗口
+                int dw = funcParams[0].toInt();
+                if (dw > 0 && traceStep > 1) {
+                    dw = std::max(3, dw / traceStep);
+                }
+                pipeline.removeDynamicWindowBackground(dw, 0, 512);
+            }
+        } else if (funcName == "BF") {
+            // BF_high,low 或 BF_high,low,taper，taper 为两侧升余弦过渡带宽度
+            if (funcParams.length() != 2 && funcParams.length() != 3) {
+                qDebug() << "bandpassFilter params error";
+            } else {
+                const auto highCut = funcParams[0].toDouble();
+                const auto lowCut = funcParams[1].toDouble();
+                const auto taperWidth = funcParams.length() == 3 ? funcParams[2].toDouble() : 0.0;
+                pipeline.bandpassFilter(lowCut, highCut, 1500, taperWidth);
+            }
+        } else if (funcName == "IIR") {
+            // IIR_high,low 或 IIR_high,low,order，Butterworth 零相位带通，默认 4 阶
+            if (funcParams.length() != 2 && funcParams.length() != 3) {
+                qDebug() << "butterworthBandpass params error";
+            } else {
+                const auto highCut = funcParams[0].toDouble();
+                const auto lowCut = funcParams[1].toDouble();
+                const auto order = funcParams.length() == 3 ? funcParams[2].toInt() : 4;
+                pipeline.butterworthBandpass(lowCut, highCut, 1500, order);
+            }
+        } else if (funcName == "ABR") {
+            if (funcParams.length() != 1) {
+                qDebug() << "adaptiveBackgroundRemoval params error";
+            } else {
+                const auto q = funcParams[0].toInt();
+                pipeline.adaptiveBackgroundRemoval(q);
+            }
+        }
+    }
+    return pipeline;
+}
+
+void RadarPipeline::run(Eigen::MatrixXf &scan) const
+{
+    run(scan, 0, m_steps.size());
+}
+
+void RadarPipeline::run(Eigen::MatrixXf &scan, const size_t firstStep, const size_t lastStep) const
+{
+    const size_t end = std::min(lastStep, m_steps.size());
+    for (size_t i = firstStep; i < end;) {
+        if (!m_steps[i].traceLocal) {
+            m_steps[i].apply(scan);
+            ++i;
+            continue;
+        }
+        // 收集连续的逐道步骤，一次遍历完成
+        std::vector<TraceKernel> kernels;
+        for (; i < end && m_steps[i].traceLocal; ++i) {
+            kernels.push_back(m_steps[i].prepare(scan.rows()));
+        }
+        runFused(scan, kernels);
+    }
+}
+
+Eigen::Index RadarPipeline::traceHalo(const Eigen::Index traces) const
+{
+    Eigen::Index halo = 0;
+    for (const Step &step : m_steps) {
+        if (step.traceLocal) {
+            continue;
+        }
+        if (!step.traceHalo || !step.applyTile) {
+            return -1;
+        }
+        halo += step.traceHalo(traces);
+    }
+    return halo;
+}
+
+void RadarPipeline::runTile(Eigen::MatrixXf &tile, const Eigen::Index traces) const
+{
+    for (size_t i = 0; i < m_steps.size();) {
+        if (!m_steps[i].traceLocal) {
+            m_steps[i].applyTile(tile, traces);
+            ++i;
+            continue;
+        }
+        std::vector<TraceKernel> kernels;
+        for (; i < m_steps.size() && m_steps[i].traceLocal; ++i) {
+            kernels.push_back(m_steps[i].prepare(tile.rows()));
+        }
+        runFused(tile, kernels);
+    }
+}
+
+const std::vector<RadarPipeline::Step> &RadarPipeline::steps() const
+{
+    return m_steps;
+}
+
+bool RadarPipeline::isEmpty() const
+{
+    return m_steps.empty();
+}
+
+RadarPipeline &RadarPipeline::addTraceStep(const QString &name,
+                                           std::initializer_list<double> params,
+                                           std::function<TraceKernel(Eigen::Index)> prepare)
+{
+    Step step;
+    step.name = name;
+    step.key = stepKey(name, params);
+    step.traceLocal = true;
+    step.prepare = std::move(prepare);
+    m_steps.push_back(std::move(step));
+    return *this;
+}
+
+RadarPipeline &RadarPipeline::addGlobalStep(const QString &name,
+                                            std::initializer_list<double> params,
+                                            std::function<void(Eigen::MatrixXf &)> apply)
+{
+    Step step;
+    step.name = name;
+    step.key = stepKey(name, params);
+    step.apply = std::move(apply);
+    m_steps.push_back(std::move(step));
+    return *this;
+}
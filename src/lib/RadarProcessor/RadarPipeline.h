@@ -0,0 +1,90 @@
+#ifndef RADARPIPELINE_H
+#define RADARPIPELINE_H
+
+#include <Eigen/Dense>
+#include <QString>
+#include <functional>
+#include <initializer_list>
+#include <vector>
+
+// 按顺序组合的雷达数据处理步骤。
+// 相邻的逐道步骤（去直流、时移、增益、时间窗去背景、带通）融合为一次遍历：
+// 矩阵按列切成能放进缓存的道块，每块依次执行全部逐道步骤后再处理下一块；
+// 需要跨道数据的步骤（沿迹线去背景、标准化）单独作用于整个矩阵
+class RadarPipeline
+{
+public:
+    // 对一组连续的道原地处理
+    using TraceKernel = std::function<void(Eigen::Ref<Eigen::MatrixXf>)>;
+
+    struct Step {
+        QString name;
+        // 步骤名与全部参数的规范表示，参数相同的步骤键相同
+        QString key;
+        // 只依赖各道自身数据，可以与相邻的逐道步骤融合
+        bool traceLocal = false;
+        // 逐道步骤：按每道采样数准备处理函数，增益曲线、滤波器系数等每次执行只计算一次
+        std::function<TraceKernel(Eigen::Index samples)> prepare;
+        // 跨道步骤：处理整个矩阵
+        std::function<void(Eigen::MatrixXf &)> apply;
+        // 跨道步骤分块执行时使用，参数为整条测线的总道数。
+        // traceHalo 返回输出的每一道依赖两侧各多少道输入，为空表示该步骤需要全部的道，不能分块；
+        // applyTile 处理一个含两侧重叠道的块，窗口等参数按总道数而不是块的道数确定
+        std::function<Eigen::Index(Eigen::Index traces)> traceHalo;
+        std::function<void(Eigen::MatrixXf &, Eigen::Index traces)> applyTile;
+    };
+
+    RadarPipeline &dewow();
+
+    RadarPipeline &startTimeShift(int shift);
+
+    RadarPipeline &exponentialGain(double scale, double exponent, double startTimes = 0, double lastTimes = 512);
+
+    RadarPipeline &removeBackground(int windowSize);
+
+    RadarPipeline &automaticGainControl(int windowSize);
+
+    RadarPipeline &bandpassFilter(double lowCut, double highCut, double samplingRate, double taperWidth = 0);
+
+    RadarPipeline &butterworthBandpass(double lowCut, double highCut, double samplingRate, int order = 4);
+
+    RadarPipeline &removeDynamicWindowBackground(int dw, int s, int e);
+
+    RadarPipeline &adaptiveBackgroundRemoval(int q);
+
+    RadarPipeline &standardizeGlobal();
+
+    RadarPipeline &standardizeByRow();
+
+    // 解析处理宏，如 "DW_0/BR_30/BF_400,100/"，每个步骤以 "/" 结尾。
+    // traceStep 为每条迹线代表的原始切片数，沿迹线方向的窗口参数按它换算
+    static RadarPipeline fromMacro(const QString &macro, int traceStep = 1);
+
+    // 依次执行全部步骤
+    void run(Eigen::MatrixXf &scan) const;
+
+    // 执行 [firstStep, lastStep) 范围内的步骤
+    void run(Eigen::MatrixXf &scan, size_t firstStep, size_t lastStep) const;
+
+    // 分块执行时每块两侧需要重叠的道数（各步骤之和），有步骤不能分块时返回 -1
+    Eigen::Index traceHalo(Eigen::Index traces) const;
+
+    // 处理总道数为 traces 的测线中的一块（含两侧重叠道），只有距块边界超过 traceHalo 的道结果有效
+    void runTile(Eigen::MatrixXf &tile, Eigen::Index traces) const;
+
+    const std::vector<Step> &steps() const;
+
+    bool isEmpty() const;
+
+private:
+    RadarPipeline &addTraceStep(const QString &name,
+                                std::initializer_list<double> params,
+                                std::function<TraceKernel(Eigen::Index)> prepare);
+    RadarPipeline &addGlobalStep(const QString &name,
+                                 std::initializer_list<double> params,
+                                 std::function<void(Eigen::MatrixXf &)> apply);
+
+    std::vector<Step> m_steps;
+};
+
+#endif // RADARPIPELINE_H
@@ -2,6 +2,9 @@
 #define RADARPROCESSOR_H
 #include <unsupported/Eigen/FFT>
 
+class PipelineCache;
+class RadarPipeline;
+
 class RadarProcessor {
 public:
     enum class ScanType {
@@ -40,18 +43,31 @@ public:
 
     RadarProcessor & adaptiveBackgroundRemoval(int q);
 
-    // Time-domain Bandpass Filter 算法：时域带通滤波，去除高频和低频噪声
-    RadarProcessor & bandpassFilter(double lowCut, double highCut, double samplingRate);
+    // Time-domain Bandpass Filter 算法：时域带通滤波，去除高频和低频噪声。
+    // taperWidth 为通带两侧升余弦过渡带的宽度（与频率同单位），0 表示矩形窗
+    RadarProcessor & bandpassFilter(double lowCut, double highCut, double samplingRate, double taperWidth = 0);
+
+    // Butterworth IIR 带通：order 阶高通与低通级联，正反向各滤一次，零相位
+    RadarProcessor & butterworthBandpass(double lowCut, double highCut, double samplingRate, int order = 4);
 
     // STC Smoothed Gain 算法：STC 平滑增益，补偿雷达信号随深度衰减的问题
     // RadarProcessor & stcSmoothedGain(int windowSize, double smoothingSize);
 
     RadarProcessor & exponentialGain(double scale, double exponent, double startTimes=0, double lastTimes=512);
 
+    // Automatic Gain Control 算法：每个采样除以以它为中心、长为 windowSize 个采样的时间窗均方根
+    RadarProcessor &automaticGainControl(int windowSize);
+
     RadarProcessor &standardizeMatrixGlobal();
 
     RadarProcessor & standardizeMatrixByRow();
 
+    // 按顺序执行处理流水线中的全部步骤
+    RadarProcessor &apply(const RadarPipeline &pipeline);
+
+    // 同上，复用 cache 中已计算的最长步骤前缀的结果，cache 须只用于同一份输入
+    RadarProcessor &apply(const RadarPipeline &pipeline, PipelineCache &cache);
+
 private:
     Eigen::MatrixXf m_scan;
     Eigen::MatrixXf m_originalScan;
@@ -0,0 +1,82 @@
+#include "TraceFFT.h"
+#include "ParallelScheduler.h"
+#include <unsupported/Eigen/FFT>
+#include <cmath>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+// 每个并行区间的道数
+constexpr std::int64_t kTraceGrain = 16;
+
+// 线程私有的 FFT 计划与频谱缓冲区
+struct FFTWorkspace {
+    FFTWorkspace()
+    {
+        fft.SetFlag(Eigen::FFT<float>::HalfSpectrum);
+        // 逆变换的 1 / nfft 归一化并入增益
+        fft.SetFlag(Eigen::FFT<float>::Unscaled);
+    }
+
+    Eigen::FFT<float> fft;
+    Eigen::VectorXcf spectrum;
+};
+
+FFTWorkspace &threadWorkspace()
+{
+    thread_local FFTWorkspace workspace;
+    return workspace;
+}
+
+} // namespace
+
+Eigen::Index TraceFFT::spectrumSize(const Eigen::Index traceLength)
+{
+    return traceLength / 2 + 1;
+}
+
+Eigen::ArrayXf TraceFFT::bandpassGains(const Eigen::Index traceLength,
+                                       const double samplingRate,
+                                       const double lowCut,
+                                       const double highCut,
+                                       const double taperWidth)
+{
+    const Eigen::Index bins = spectrumSize(traceLength);
+    Eigen::ArrayXf gains(bins);
+    const double df = samplingRate / traceLength;
+    for (Eigen::Index k = 0; k < bins; ++k) {
+        const double freq = k * df;
+        // 到通带的距离
+        const double distance = freq < lowCut ? lowCut - freq : freq > highCut ? freq - highCut : 0.0;
+        if (distance == 0.0) {
+            gains[k] = 1.0f;
+        } else if (distance < taperWidth) {
+            gains[k] = float(0.5 * (1.0 + std::cos(kPi * distance / taperWidth)));
+        } else {
+            gains[k] = 0.0f;
+        }
+    }
+    return gains;
+}
+
+void TraceFFT::filterTraces(Eigen::Ref<Eigen::MatrixXf> traces, const Eigen::ArrayXf &gains)
+{
+    const Eigen::Index nfft = traces.rows();
+    const Eigen::Index traceCount = traces.cols();
+    if (nfft == 0 || gains.size() != spectrumSize(nfft)) {
+        return;
+    }
+    const Eigen::ArrayXf scaledGains = gains / float(nfft);
+
+    ParallelScheduler::instance().parallelFor(
+        0, traceCount, kTraceGrain, [&](const std::int64_t first, const std::int64_t last) {
+            FFTWorkspace &workspace = threadWorkspace();
+            workspace.spectrum.resize(scaledGains.size());
+            for (Eigen::Index i = first; i < last; ++i) {
+                float *trace = traces.col(i).data();
+                workspace.fft.fwd(workspace.spectrum.data(), trace, nfft);
+                workspace.spectrum.array() *= scaledGains;
+                workspace.fft.inv(trace, workspace.spectrum.data(), nfft);
+            }
+        });
+}
@@ -0,0 +1,27 @@
+#ifndef TRACEFFT_H
+#define TRACEFFT_H
+
+#include <Eigen/Dense>
+
+// 沿道（列）方向批量做实数 FFT 滤波。
+// 每个线程持有一个 FFT 对象（按道长缓存计划与旋转因子）和对齐的频谱缓冲区，跨调用复用；
+// 正变换只计算 nfft / 2 + 1 个非负频率，逆变换直接写回原数据，不拷贝道
+class TraceFFT
+{
+public:
+    // 长度为 traceLength 的实数道的频点数：nfft / 2 + 1
+    static Eigen::Index spectrumSize(Eigen::Index traceLength);
+
+    // 带通增益，下标 k 对应频率 k * samplingRate / traceLength。
+    // [lowCut, highCut] 内为 1，两侧各 taperWidth 内按升余弦过渡到 0；taperWidth 为 0 时为矩形窗
+    static Eigen::ArrayXf bandpassGains(Eigen::Index traceLength,
+                                        double samplingRate,
+                                        double lowCut,
+                                        double highCut,
+                                        double taperWidth = 0);
+
+    // 对 traces 的每一列原地执行：正变换 → 乘以 gains（spectrumSize 项）→ 逆变换，按道并行
+    static void filterTraces(Eigen::Ref<Eigen::MatrixXf> traces, const Eigen::ArrayXf &gains);
+};
+
+#endif // TRACEFFT_H
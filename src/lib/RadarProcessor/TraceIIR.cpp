@@ -0,0 +1,156 @@
+#include "TraceIIR.h"
+#include "ParallelScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int kLanes = 8;
+using Lanes = Eigen::Array<float, kLanes, 1>;
+// 每个并行区间的道组数，区间内复用交错缓冲区
+constexpr std::int64_t kGroupGrain = 4;
+
+// 单精度系数与稳态初始状态
+struct SectionCoefficients {
+    float b0, b1, b2, a1, a2;
+    // 输入恒为 1 时的状态：z1 = zi1 * x0，z2 = zi2 * x0
+    float zi1, zi2;
+};
+
+// RBJ 二阶低通/高通，Q 取 Butterworth 级联的各节品质因数
+Biquad secondOrderSection(const double cutoff, const double samplingRate, const double q, const bool highPass)
+{
+    const double w0 = 2.0 * kPi * cutoff / samplingRate;
+    const double cosW0 = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double a0 = 1.0 + alpha;
+
+    Biquad section;
+    if (highPass) {
+        section.b0 = (1.0 + cosW0) / 2.0 / a0;
+        section.b1 = -(1.0 + cosW0) / a0;
+    } else {
+        section.b0 = (1.0 - cosW0) / 2.0 / a0;
+        section.b1 = (1.0 - cosW0) / a0;
+    }
+    section.b2 = section.b0;
+    section.a1 = -2.0 * cosW0 / a0;
+    section.a2 = (1.0 - alpha) / a0;
+    return section;
+}
+
+SectionCoefficients prepare(const Biquad &section)
+{
+    // 转置直接 II 型在恒定输入下的稳态，g 为直流增益
+    const double g = (section.b0 + section.b1 + section.b2) / (1.0 + section.a1 + section.a2);
+    const double zi2 = section.b2 - section.a2 * g;
+    const double zi1 = section.b1 - section.a1 * g + zi2;
+    return {float(section.b0),
+            float(section.b1),
+            float(section.b2),
+            float(section.a1),
+            float(section.a2),
+            float(zi1),
+            float(zi2)};
+}
+
+// 对交错缓冲区 samples × kLanes 做一次正向或反向通过
+void runSection(float *buffer, const Eigen::Index samples, const SectionCoefficients &c, const bool reverse)
+{
+    const Eigen::Index first = reverse ? samples - 1 : 0;
+    const Eigen::Index step = reverse ? -1 : 1;
+
+    const Lanes x0 = Eigen::Map<const Lanes>(buffer + first * kLanes);
+    Lanes z1 = c.zi1 * x0;
+    Lanes z2 = c.zi2 * x0;
+    for (Eigen::Index n = 0, t = first; n < samples; ++n, t += step) {
+        Eigen::Map<Lanes> value(buffer + t * kLanes);
+        const Lanes x = value;
+        const Lanes y = c.b0 * x + z1;
+        z1 = c.b1 * x - c.a1 * y + z2;
+        z2 = c.b2 * x - c.a2 * y;
+        value = y;
+    }
+}
+
+} // namespace
+
+std::vector<Biquad> TraceIIR::butterworthBandpass(const double lowCut,
+                                                  const double highCut,
+                                                  const double samplingRate,
+                                                  int order)
+{
+    std::vector<Biquad> sections;
+    if (samplingRate <= 0 || order <= 0) {
+        return sections;
+    }
+    order += order % 2;
+
+    // order 阶 Butterworth 拆为 order / 2 个二阶节，第 k 节 Q = 1 / (2 cos((2k + 1)π / (2 order)))
+    const auto addSections = [&](const double cutoff, const bool highPass) {
+        for (int k = 0; k < order / 2; ++k) {
+            const double q = 1.0 / (2.0 * std::cos((2 * k + 1) * kPi / (2.0 * order)));
+            sections.push_back(secondOrderSection(cutoff, samplingRate, q, highPass));
+        }
+    };
+    if (lowCut > 0 && lowCut < samplingRate / 2) {
+        addSections(lowCut, true);
+    }
+    if (highCut > 0 && highCut < samplingRate / 2) {
+        addSections(highCut, false);
+    }
+    return sections;
+}
+
+void TraceIIR::filtfiltTraces(Eigen::Ref<Eigen::MatrixXf> traces, const std::vector<Biquad> &sections)
+{
+    const Eigen::Index samples = traces.rows();
+    const Eigen::Index traceCount = traces.cols();
+    if (samples == 0 || sections.empty()) {
+        return;
+    }
+
+    std::vector<SectionCoefficients> coefficients;
+    coefficients.reserve(sections.size());
+    for (const Biquad &section : sections) {
+        coefficients.push_back(prepare(section));
+    }
+    const Eigen::Index groups = (traceCount + kLanes - 1) / kLanes;
+
+    ParallelScheduler::instance().parallelFor(
+        0, groups, kGroupGrain, [&](const std::int64_t firstGroup, const std::int64_t lastGroup) {
+            // 第 t 个采样的 8 道连续存放
+            Eigen::ArrayXf buffer(samples * kLanes);
+            float *data = buffer.data();
+
+            for (Eigen::Index group = firstGroup; group < lastGroup; ++group) {
+                const Eigen::Index firstTrace = group * kLanes;
+                const int lanes = int(std::min<Eigen::Index>(kLanes, traceCount - firstTrace));
+
+                if (lanes < kLanes) {
+                    buffer.setZero();
+                }
+                for (int lane = 0; lane < lanes; ++lane) {
+                    const float *trace = traces.col(firstTrace + lane).data();
+                    for (Eigen::Index t = 0; t < samples; ++t) {
+                        data[t * kLanes + lane] = trace[t];
+                    }
+                }
+
+                for (const SectionCoefficients &c : coefficients) {
+                    runSection(data, samples, c, false);
+                }
+                for (const SectionCoefficients &c : coefficients) {
+                    runSection(data, samples, c, true);
+                }
+
+                for (int lane = 0; lane < lanes; ++lane) {
+                    float *trace = traces.col(firstTrace + lane).data();
+                    for (Eigen::Index t = 0; t < samples; ++t) {
+                        trace[t] = data[t * kLanes + lane];
+                    }
+                }
+            }
+        });
+}
@@ -0,0 +1,31 @@
+#ifndef TRACEIIR_H
+#define TRACEIIR_H
+
+#include <Eigen/Dense>
+#include <vector>
+
+// 二阶节，a0 归一化为 1：y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+struct Biquad {
+    double b0 = 1.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+};
+
+// 沿道（列）方向的时域 IIR 滤波。
+// 相邻 8 道交错存放到线程私有缓冲区，每个时间点 8 道作为 SIMD 的 8 个通道同时更新，
+// 每道代价 O(采样数 × 节数)，处理过程中不按道分配内存
+class TraceIIR
+{
+public:
+    // Butterworth 带通：order 阶高通（lowCut）与 order 阶低通（highCut）级联，双线性变换并预畸变。
+    // order 为奇数时向上取偶；lowCut <= 0 时省略高通，highCut >= 奈奎斯特频率时省略低通
+    static std::vector<Biquad> butterworthBandpass(double lowCut, double highCut, double samplingRate, int order);
+
+    // 零相位滤波：每道先正向、再反向通过全部二阶节，幅频响应为单次的平方。
+    // 每次通过前按首个采样的稳态设置初始状态，减小道首尾的瞬态
+    static void filtfiltTraces(Eigen::Ref<Eigen::MatrixXf> traces, const std::vector<Biquad> &sections);
+};
+
+#endif // TRACEIIR_H
@@ -3,6 +3,7 @@
 //
 
 #include "ScanImageProvider.h"
+#include "ParallelScheduler.h"
 
 inline Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic> adjustContrast(
     const Eigen::MatrixXf &scan, const double contrastValue)
@@ -30,57 +31,15 @@ ScanImageProvider::ScanImageProvider(QObject *parent)
 
 void ScanImageProvider::processScanMacro(const QString &macroStr)
 {
+    // 交互处理期间限制处理内核的线程数，给界面留出核心
+    const ParallelScheduler::UiBusyScope uiBusy;
     m_macroStr = macroStr;
     m_processorScan.resetOriginalScan();
     if (m_macroStr.isEmpty()) {
         return;
     }
-    QStringList funcs = m_macroStr.split("/");
-    for (int i = 0; i < funcs.length() - 1; i++) {
-        auto tmp = funcs[i].split("_");
-        auto funcName = tmp[0];
-        auto funcParams = tmp[1].split(",");
-        // qDebug() << funcName << " " << funcParams;
-
-        if (funcName == "DW") {
-            m_processorScan.dewow();
-        } else if (funcName == "STS") {
-            m_processorScan.startTimeShifter(-29);
-        } else if (funcName == "EG") {
-            if (funcParams.length() != 2) {
-                qDebug() << "exponentialGain params error";
-            } else {
-                const auto exponent = funcParams[0].toDouble();
-                const auto exponentScale = funcParams[1].toDouble();
-                m_processorScan.exponentialGain(exponentScale, exponent, 0, 483);
-            }
-        } else if (funcName == "BR") {
-            if (funcParams.length() != 1) {
-                qDebug() << "removeDynamicWindowBackground params error";
-            } else {
-                const auto dw = funcParams[0].toInt();
-                m_processorScan.removeDynamicWindowBackground(dw, 0, 512);
-            }
-        } else if (funcName == "BF") {
-            if (funcParams.length() != 2) {
-                qDebug() << "bandpassFilter params error";
-            } else {
-                const auto highCut = funcParams[0].toDouble();
-                const auto lowCut = funcParams[1].toDouble();
-                m_processorScan.bandpassFilter(lowCut, highCut, 1500);
-            }
-        } else if (funcName == "ABR") {
-            if (funcParams.length() != 1) {
-                qDebug() << "adaptiveBackgroundRemoval params error";
-            } else {
-                const auto q = funcParams[0].toInt();
-                m_processorScan.adaptiveBackgroundRemoval(q);
-            }
-        }
-        else {
-            // Default case
-        }
-    }
+    // 从缓存中最长的相同步骤前缀继续处理
+    m_processorScan.apply(RadarPipeline::fromMacro(m_macroStr, m_traceStep), m_pipelineCache);
 
     if (m_processorScan.scanType() == RadarProcessor::ScanType::BScan) {
         qDebug() << "BScan";
@@ -93,7 +52,14 @@ void ScanImageProvider::processScanMacro(const QString &macroStr)
 
 QImage ScanImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
 {
-    Q_UNUSED(requestedSize);
+    const ParallelScheduler::UiBusyScope uiBusy;
+
+    // 未指定的维度使用 setScan / setOverviewBScan 给出的显示尺寸
+    const int width = requestedSize.width() > 0 ? requestedSize.width() : m_width;
+    const int height = requestedSize.height() > 0 ? requestedSize.height() : m_height;
+    if (m_overviewParser) {
+        loadOverviewLevel(width);
+    }
 
     if (m_processorScan.scan().cols() == 0 || m_processorScan.scan().rows() == 0) {
         qDebug() << "scan is empty";
@@ -101,7 +67,7 @@ QImage ScanImageProvider::requestImage(const QString &id, QSize *size, const QSi
     }
 
     if (size) {
-        *size = QSize(m_width, m_height);
+        *size = QSize(width, height);
     }
     const auto splitedId = id.split("#");
     const auto contrast = splitedId[0].toDouble();
@@ -118,7 +84,7 @@ QImage ScanImageProvider::requestImage(const QString &id, QSize *size, const QSi
     cv::eigen2cv(finalScan, cvMat);
     cv::normalize(cvMat, cvMat, 0, 255, cv::NORM_MINMAX, CV_8UC1);
     const QImage image(cvMat.data, cvMat.cols, cvMat.rows, cvMat.step, QImage::Format_Grayscale8);
-    m_image = image.scaled(m_width, m_height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    m_image = image.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
     m_cvMat = cvMat;
     return m_image;
 }
@@ -129,10 +95,47 @@ void ScanImageProvider::setScan(
     m_processorScan = processorBscan;
     m_width = width;
     m_height = height;
+    m_traceStep = 1;
+    m_overviewParser = nullptr;
+    m_overviewLevel = -1;
     m_macroStr = "";
+    m_pipelineCache.clear();
+    emit scanUpdated();
+}
+
+void ScanImageProvider::setOverviewBScan(
+    const OGPRParser &parser, const int channelIndex, const int width, const int height)
+{
+    m_overviewParser = &parser;
+    m_overviewChannel = channelIndex;
+    m_overviewLevel = -1;
+    m_width = width;
+    m_height = height;
+    loadOverviewLevel(width);
     emit scanUpdated();
 }
 
+void ScanImageProvider::loadOverviewLevel(const int width)
+{
+    const int level = m_overviewParser->getOverviewPyramid().levelForWidth(width);
+    if (level == m_overviewLevel) {
+        return;
+    }
+    // 第 0 层为完整的 BScan，只在请求全分辨率时载入
+    Eigen::MatrixXf bScan;
+    m_overviewLevel = m_overviewParser->copyOverviewBScan(m_overviewChannel, width, bScan);
+    m_processorScan = RadarProcessor(std::move(bScan), RadarProcessor::ScanType::BScan);
+    m_traceStep = 1 << m_overviewLevel;
+    // 换层后窗口参数的换算随之改变，缓存的中间结果不再适用，宏需要重新处理
+    m_macroStr = "";
+    m_pipelineCache.clear();
+}
+
+void ScanImageProvider::setProcessingCacheBudget(const qint64 bytes)
+{
+    m_pipelineCache.setMaxBytes(bytes);
+}
+
 QImage ScanImageProvider::image() const
 {
     if (m_image.isNull()) {
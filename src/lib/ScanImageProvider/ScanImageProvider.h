@@ -5,6 +5,9 @@
 #ifndef SCANIMAGEPROVIDER_H
 #define SCANIMAGEPROVIDER_H
 
+#include "OGPRParser.h"
+#include "PipelineCache.h"
+#include "RadarPipeline.h"
 #include "RadarProcessor.h"
 #include <Eigen/Core>
 #include <opencv2/core/eigen.hpp>
@@ -21,16 +24,34 @@ public:
 
     void setScan(const RadarProcessor &processorBscan, int width, int height);
 
+    // 概览模式：从概览金字塔中取迹线数不少于显示宽度的最粗一层 BScan，
+    // 宏处理与显示都在降采样后的数据上进行。之后每次 requestImage 按请求的宽度重新选层，
+    // 只有需要全分辨率时才使用完整的 BScan。parser 须在切换数据之前保持有效
+    void setOverviewBScan(const OGPRParser &parser, int channelIndex, int width, int height);
+
+    // 处理中间结果缓存的内存预算（字节）
+    void setProcessingCacheBudget(qint64 bytes);
+
     QImage image() const;
     cv::Mat cvMat() const;
 signals:
     void scanUpdated();
 private:
     void processScanMacro(const QString &rawStr);
+    // 概览模式下载入宽度 width 对应的金字塔层，层号不变时不重新载入
+    void loadOverviewLevel(int width);
     RadarProcessor m_processorScan;
+    // 按步骤前缀缓存宏处理的中间结果，调整某一步的参数时只重算该步及其后的步骤；切换数据时清空
+    PipelineCache m_pipelineCache;
     QString m_macroStr;
     int m_width = 512;
     int m_height = 512;
+    // 每条迹线代表的原始切片数，概览模式下用于换算沿迹线方向的窗口参数
+    int m_traceStep = 1;
+    // 概览模式的数据来源，非概览模式下为空
+    const OGPRParser *m_overviewParser = nullptr;
+    int m_overviewChannel = 0;
+    int m_overviewLevel = -1;
     QImage m_image;
     cv::Mat m_cvMat;
 };
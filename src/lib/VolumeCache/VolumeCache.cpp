@@ -0,0 +1,338 @@
+#include "VolumeCache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'G', 'P', 'R', 'V', 'C', '\0', '\1'};
+constexpr quint32 kVersion = 1;
+constexpr qint64 kDataAlignment = 64;
+// 写入时每批处理的字节数上限
+constexpr qint64 kWriteChunkBytes = 16 * 1024 * 1024;
+
+// 缓存文件头部，之后依次为处理参数（UTF-8）与补齐到 64 字节边界的填充
+struct CacheHeader {
+    char magic[8];
+    quint32 version;
+    quint32 format;
+    qint64 samples;
+    qint64 channels;
+    qint64 slices;
+    float aAdj;
+    float bAdj;
+    char sourceMd5[32];
+    quint32 processingBytes;
+    quint32 reserved;
+};
+
+qint64 sampleBytes(const CachedVolume::Format format)
+{
+    return format == CachedVolume::Format::Int16 ? qint64(sizeof(int16_t)) : qint64(sizeof(float));
+}
+
+qint64 dataOffset(const qint64 processingBytes)
+{
+    const qint64 headerBytes = qint64(sizeof(CacheHeader)) + processingBytes;
+    return (headerBytes + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+
+// 数据区恰好为 samples * channels * slices 个采样。逐个维度与剩余字节数比较后再相乘，
+// 损坏的文件头不会因乘积溢出而通过检查
+bool matchesDataBytes(const qint64 dataBytes,
+                      const qint64 samples,
+                      const qint64 channels,
+                      const qint64 slices,
+                      const qint64 bytesPerSample)
+{
+    if (dataBytes < 0) {
+        return false;
+    }
+    qint64 total = bytesPerSample;
+    for (const qint64 dimension : {samples, channels, slices}) {
+        if (dimension < 0 || (dimension > 0 && total > dataBytes / dimension)) {
+            return false;
+        }
+        total *= dimension;
+    }
+    return total == dataBytes;
+}
+
+QByteArray normalizedMd5(const QString &md5)
+{
+    return md5.trimmed().toLower().toLatin1().leftJustified(32, '\0', true);
+}
+
+} // namespace
+
+CachedVolume::~CachedVolume()
+{
+    m_voltages.clear();
+    m_samples.clear();
+    if (m_file && m_mappedData) {
+        m_file->unmap(m_mappedData);
+    }
+}
+
+CachedVolume::Format CachedVolume::format() const
+{
+    return m_format;
+}
+
+CachedVolume::Index CachedVolume::samplesCount() const
+{
+    return m_format == Format::Int16 ? m_samples.samplesCount() : m_voltages.samplesCount();
+}
+
+CachedVolume::Index CachedVolume::channelsCount() const
+{
+    return m_format == Format::Int16 ? m_samples.channelsCount() : m_voltages.channelsCount();
+}
+
+CachedVolume::Index CachedVolume::slicesCount() const
+{
+    return m_format == Format::Int16 ? m_samples.slicesCount() : m_voltages.slicesCount();
+}
+
+const float *CachedVolume::voltageData() const
+{
+    return m_format == Format::Float32 ? m_voltages.data() : nullptr;
+}
+
+void CachedVolume::extractBScan(const Index channelIndex, Eigen::MatrixXf &out) const
+{
+    if (m_format == Format::Int16) {
+        m_samples.extractBScan(channelIndex, out);
+    } else {
+        m_voltages.extractBScan(channelIndex, out);
+    }
+}
+
+void CachedVolume::extractCScan(const Index depthIndex, Eigen::MatrixXf &out) const
+{
+    if (m_format == Format::Int16) {
+        m_samples.extractCScan(depthIndex, out);
+    } else {
+        m_voltages.extractCScan(depthIndex, out);
+    }
+}
+
+void CachedVolume::extractTScan(const Index sliceIndex, Eigen::MatrixXf &out) const
+{
+    if (m_format == Format::Int16) {
+        m_samples.extractTScan(sliceIndex, out);
+    } else {
+        m_voltages.extractTScan(sliceIndex, out);
+    }
+}
+
+VolumeCache::VolumeCache(const QString &directory, const qint64 maxBytes)
+    : m_directory(directory)
+    , m_maxBytes(maxBytes)
+{
+    if (m_directory.isEmpty()) {
+        m_directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/volumes";
+    }
+    QDir().mkpath(m_directory);
+}
+
+QString VolumeCache::directory() const
+{
+    return m_directory;
+}
+
+qint64 VolumeCache::maxBytes() const
+{
+    return m_maxBytes;
+}
+
+void VolumeCache::setMaxBytes(const qint64 maxBytes)
+{
+    m_maxBytes = maxBytes;
+}
+
+QString VolumeCache::entryPath(const QString &sourceMd5, const QString &processing) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(normalizedMd5(sourceMd5));
+    hash.addData(processing.toUtf8());
+    return QDir(m_directory).filePath(QString::fromLatin1(hash.result().toHex()) + ".ogprcache");
+}
+
+bool VolumeCache::contains(const QString &sourceMd5, const QString &processing) const
+{
+    return QFile::exists(entryPath(sourceMd5, processing));
+}
+
+std::optional<CachedVolume> VolumeCache::open(const QString &sourceMd5, const QString &processing) const
+{
+    auto file = std::make_unique<QFile>(entryPath(sourceMd5, processing));
+    if (!file->open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    CacheHeader header;
+    if (file->read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))
+        || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion
+        || header.format > quint32(CachedVolume::Format::Int16)) {
+        qWarning() << "Invalid volume cache entry:" << file->fileName();
+        return std::nullopt;
+    }
+    // 键是哈希值，再核对完整的 MD5 与处理参数
+    const QByteArray processingUtf8 = processing.toUtf8();
+    if (QByteArray(header.sourceMd5, 32) != normalizedMd5(sourceMd5)
+        || header.processingBytes != quint32(processingUtf8.size())
+        || file->read(header.processingBytes) != processingUtf8) {
+        return std::nullopt;
+    }
+
+    const auto format = CachedVolume::Format(header.format);
+    const qint64 offset = dataOffset(header.processingBytes);
+    if (!matchesDataBytes(
+            file->size() - offset, header.samples, header.channels, header.slices, sampleBytes(format))) {
+        qWarning() << "Truncated volume cache entry:" << file->fileName();
+        return std::nullopt;
+    }
+
+    uchar *mapped = file->map(0, file->size());
+    if (!mapped) {
+        qWarning() << "Failed to map volume cache entry:" << file->fileName();
+        return std::nullopt;
+    }
+    // 修改时间作为最近使用时间
+    file->setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    CachedVolume volume;
+    volume.m_format = format;
+    if (format == CachedVolume::Format::Int16) {
+        volume.m_samples.setView(
+            reinterpret_cast<const int16_t *>(mapped + offset), header.samples, header.channels, header.slices);
+        volume.m_samples.setCalibration({header.aAdj, header.bAdj});
+    } else {
+        volume.m_voltages.setView(
+            reinterpret_cast<const float *>(mapped + offset), header.samples, header.channels, header.slices);
+        volume.m_voltages.setCalibration({1.0f, 0.0f});
+    }
+    volume.m_mappedData = mapped;
+    volume.m_file = std::move(file);
+    return volume;
+}
+
+bool VolumeCache::store(const QString &sourceMd5,
+                        const QString &processing,
+                        const Eigen::Tensor<float, 3> &volume,
+                        const CachedVolume::Format format)
+{
+    const QString path = entryPath(sourceMd5, processing);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to create volume cache entry:" << path;
+        return false;
+    }
+
+    const qint64 samples = volume.dimension(0);
+    const qint64 channels = volume.dimension(1);
+    const qint64 slices = volume.dimension(2);
+    const QByteArray processingUtf8 = processing.toUtf8();
+
+    // Int16 按最大绝对值量化到满量程：digital = voltage * aAdj
+    VoltageCalibration calibration{1.0f, 0.0f};
+    if (format == CachedVolume::Format::Int16 && volume.size() > 0) {
+        const Eigen::Tensor<float, 0> maxAbs = volume.abs().maximum();
+        if (maxAbs() > 0.0f) {
+            calibration.aAdj = 32767.0f / maxAbs();
+        }
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.format = quint32(format);
+    header.samples = samples;
+    header.channels = channels;
+    header.slices = slices;
+    header.aAdj = calibration.aAdj;
+    header.bAdj = calibration.bAdj;
+    std::memcpy(header.sourceMd5, normalizedMd5(sourceMd5).constData(), sizeof(header.sourceMd5));
+    header.processingBytes = quint32(processingUtf8.size());
+
+    QByteArray prefix(reinterpret_cast<const char *>(&header), sizeof(header));
+    prefix.append(processingUtf8);
+    prefix.append(QByteArray(dataOffset(processingUtf8.size()) - prefix.size(), '\0'));
+    bool ok = file.write(prefix) == prefix.size();
+
+    // 按切片分批写入，量化时的临时内存不超过一批
+    const qint64 sliceSamples = samples * channels;
+    const qint64 slicesPerChunk
+        = std::max<qint64>(1, kWriteChunkBytes / std::max<qint64>(1, sliceSamples * sampleBytes(format)));
+    std::vector<int16_t> quantized;
+    for (qint64 first = 0; ok && first < slices; first += slicesPerChunk) {
+        const qint64 count = std::min(slicesPerChunk, slices - first);
+        const float *src = volume.data() + first * sliceSamples;
+        if (format == CachedVolume::Format::Int16) {
+            quantized.resize(size_t(count * sliceSamples));
+            Eigen::Map<Eigen::Array<int16_t, Eigen::Dynamic, 1>>(quantized.data(), count * sliceSamples)
+                = (Eigen::Map<const Eigen::ArrayXf>(src, count * sliceSamples) * calibration.aAdj)
+                      .round()
+                      .max(-32767.0f)
+                      .min(32767.0f)
+                      .cast<int16_t>();
+            const qint64 bytes = count * sliceSamples * qint64(sizeof(int16_t));
+            ok = file.write(reinterpret_cast<const char *>(quantized.data()), bytes) == bytes;
+        } else {
+            const qint64 bytes = count * sliceSamples * qint64(sizeof(float));
+            ok = file.write(reinterpret_cast<const char *>(src), bytes) == bytes;
+        }
+    }
+
+    if (!ok || !file.commit()) {
+        qWarning() << "Failed to write volume cache entry:" << path;
+        file.cancelWriting();
+        return false;
+    }
+    evict();
+    return true;
+}
+
+bool VolumeCache::remove(const QString &sourceMd5, const QString &processing) const
+{
+    return QFile::remove(entryPath(sourceMd5, processing));
+}
+
+void VolumeCache::evict() const
+{
+    // 按修改时间从旧到新
+    const QFileInfoList entries = QDir(m_directory).entryInfoList(
+        {"*.ogprcache"}, QDir::Files, QDir::Time | QDir::Reversed);
+    qint64 total = 0;
+    for (const QFileInfo &entry : entries) {
+        total += entry.size();
+    }
+    for (const QFileInfo &entry : entries) {
+        if (total <= m_maxBytes) {
+            break;
+        }
+        // 仍被映射的条目在部分平台上无法删除，跳过即可
+        if (QFile::remove(entry.absoluteFilePath())) {
+            total -= entry.size();
+        }
+    }
+}
+
+qint64 VolumeCache::totalBytes() const
+{
+    qint64 total = 0;
+    const QFileInfoList entries = QDir(m_directory).entryInfoList({"*.ogprcache"}, QDir::Files);
+    for (const QFileInfo &entry : entries) {
+        total += entry.size();
+    }
+    return total;
+}
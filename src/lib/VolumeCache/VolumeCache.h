@@ -0,0 +1,99 @@
+#ifndef VOLUMECACHE_H
+#define VOLUMECACHE_H
+
+#include <QFile>
+#include <QString>
+#include <memory>
+#include <optional>
+#include "VolumeStorage.h"
+
+// 缓存中的数据体，文件整体映射到内存，只读。
+// Float32 直接保存电压值；Int16 为按最大绝对值量化的采样，提取切片时再按标定系数还原
+class CachedVolume
+{
+public:
+    enum class Format : quint32 {
+        Float32 = 0,
+        Int16 = 1
+    };
+
+    using Index = Eigen::Index;
+
+    CachedVolume() = default;
+    ~CachedVolume();
+
+    CachedVolume(CachedVolume &&other) noexcept = default;
+    CachedVolume &operator=(CachedVolume &&other) noexcept = default;
+
+    Format format() const;
+
+    Index samplesCount() const;
+    Index channelsCount() const;
+    Index slicesCount() const;
+
+    // Float32 缓存的电压值，列优先 (samples, channels, slices)；Int16 缓存为 nullptr
+    const float *voltageData() const;
+
+    // 获取 BScan 切片（通道方向）：(samples, slices)
+    void extractBScan(Index channelIndex, Eigen::MatrixXf &out) const;
+
+    // 获取 CScan 切片（深度方向）：(channels, slices)
+    void extractCScan(Index depthIndex, Eigen::MatrixXf &out) const;
+
+    // 获取 TScan 切片（行进方向）：(samples, channels)
+    void extractTScan(Index sliceIndex, Eigen::MatrixXf &out) const;
+
+private:
+    friend class VolumeCache;
+
+    Format m_format = Format::Float32;
+    std::unique_ptr<QFile> m_file;
+    uchar *m_mappedData = nullptr;
+    VolumeStorage<float> m_voltages;
+    VolumeStorage<int16_t> m_samples;
+};
+
+// 处理后数据体的旁路缓存，以源文件 MD5 与处理参数（如宏字符串）为键。
+// 每个条目是一个独立的 .ogprcache 文件：64 字节对齐的头部之后紧跟列优先的数据，
+// 打开缓存即映射文件，无需重新解析与处理。
+// 条目的修改时间即最近使用时间，写入后按最近最少使用淘汰，直到总大小不超过上限
+class VolumeCache
+{
+public:
+    // directory 为空时使用系统缓存目录下的 volumes 子目录
+    explicit VolumeCache(const QString &directory = QString(), qint64 maxBytes = 4LL * 1024 * 1024 * 1024);
+
+    QString directory() const;
+
+    qint64 maxBytes() const;
+    void setMaxBytes(qint64 maxBytes);
+
+    // 条目文件路径
+    QString entryPath(const QString &sourceMd5, const QString &processing) const;
+
+    bool contains(const QString &sourceMd5, const QString &processing) const;
+
+    // 映射缓存条目，不存在或校验失败时返回空
+    std::optional<CachedVolume> open(const QString &sourceMd5, const QString &processing) const;
+
+    // 写入 (samples, channels, slices) 电压数据体，先写临时文件再原子替换，随后按上限淘汰
+    bool store(const QString &sourceMd5,
+               const QString &processing,
+               const Eigen::Tensor<float, 3> &volume,
+               CachedVolume::Format format = CachedVolume::Format::Float32);
+
+    // 删除条目
+    bool remove(const QString &sourceMd5, const QString &processing) const;
+
+    // 按最近使用时间从旧到新删除条目，直到总大小不超过上限
+    void evict() const;
+
+    // 全部条目占用的字节数
+    qint64 totalBytes() const;
+
+private:
+    QString m_directory;
+    qint64 m_maxBytes;
+};
+
+#endif // VOLUMECACHE_H
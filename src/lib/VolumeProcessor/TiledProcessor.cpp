@@ -0,0 +1,132 @@
+#include "TiledProcessor.h"
+#include "OGPRParser.h"
+#include "ParallelScheduler.h"
+#include "RadarPipeline.h"
+#include <QDebug>
+#include <QFile>
+#include <algorithm>
+#include <future>
+#include <vector>
+
+namespace {
+
+using Index = Eigen::Index;
+using Stride = Eigen::Stride<Eigen::Dynamic, 1>;
+
+// 一块的输入：各通道 [inputFirst, inputFirst + width) 道，其中 [first, first + count) 为有效道
+struct Tile {
+    Index first = 0;
+    Index count = 0;
+    Index inputFirst = 0;
+    Index width = 0;
+    std::vector<Eigen::MatrixXf> scans;
+};
+
+} // namespace
+
+bool TiledProcessor::process(const TraceReader &reader,
+                             const Index samples,
+                             const Index channels,
+                             const Index traces,
+                             const RadarPipeline &pipeline,
+                             const QString &outputPath,
+                             const qint64 memoryBudget)
+{
+    if (samples <= 0 || channels <= 0 || traces <= 0) {
+        qWarning() << "No radar data to process";
+        return false;
+    }
+    const Index halo = pipeline.traceHalo(traces);
+    if (halo < 0) {
+        qWarning() << "Pipeline contains steps that need the whole line and cannot be tiled";
+        return false;
+    }
+
+    // 当前块、预读的下一块与处理时的临时矩阵约占三份
+    const qint64 traceBytes = samples * channels * qint64(sizeof(float));
+    const Index budgetWidth = memoryBudget / (3 * traceBytes);
+    // 块宽不小于窗口的 4 倍，块内不会再按块宽收窄背景去除窗口
+    const Index minCount = 8 * halo + 8;
+    const Index count = std::min(traces, std::max(budgetWidth - 2 * halo, minCount));
+    const Index tileWidth = std::min(traces, count + 2 * halo);
+    if (3 * tileWidth * traceBytes > memoryBudget) {
+        qWarning() << "Tile of" << tileWidth << "traces exceeds the memory budget of" << memoryBudget << "bytes";
+    }
+
+    QFile file(outputPath);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !file.resize(traces * traceBytes)) {
+        qWarning() << "Failed to create output file:" << outputPath;
+        return false;
+    }
+
+    const auto readTile = [&reader, channels, traces, halo, count, tileWidth](const Index first) {
+        Tile tile;
+        tile.first = first;
+        tile.count = std::min(count, traces - first);
+        // 两侧各多读 halo 道，靠近测线两端时向内侧补足，保持块宽
+        const Index inputLast = std::min(traces, std::max(first + tile.count + halo, tileWidth));
+        tile.inputFirst = std::max<Index>(0, std::min(first - halo, inputLast - tileWidth));
+        tile.width = inputLast - tile.inputFirst;
+        tile.scans.resize(size_t(channels));
+        for (Index channel = 0; channel < channels; ++channel) {
+            reader(int(channel), tile.inputFirst, tile.width, tile.scans[size_t(channel)]);
+        }
+        return tile;
+    };
+
+    auto &scheduler = ParallelScheduler::instance();
+    std::future<Tile> next = std::async(std::launch::async, readTile, Index(0));
+    for (Index first = 0; first < traces; first += count) {
+        Tile tile = next.get();
+        if (first + count < traces) {
+            next = std::async(std::launch::async, readTile, first + count);
+        }
+        for (const Eigen::MatrixXf &scan : tile.scans) {
+            if (scan.rows() != samples || scan.cols() != tile.width) {
+                qWarning() << "Failed to read traces" << tile.inputFirst << "to" << tile.inputFirst + tile.width;
+                return false;
+            }
+        }
+
+        uchar *mapped = file.map(tile.first * traceBytes, tile.count * traceBytes);
+        if (!mapped) {
+            qWarning() << "Failed to map output file:" << outputPath;
+            return false;
+        }
+        auto *out = reinterpret_cast<float *>(mapped);
+        const auto processRange = [&](const std::int64_t firstChannel, const std::int64_t lastChannel) {
+            for (Index channel = firstChannel; channel < lastChannel; ++channel) {
+                Eigen::MatrixXf &scan = tile.scans[size_t(channel)];
+                pipeline.runTile(scan, traces);
+                Eigen::Map<Eigen::MatrixXf, 0, Stride>(
+                    out + channel * samples, samples, tile.count, Stride(samples * channels, 1))
+                    = scan.middleCols(tile.first - tile.inputFirst, tile.count);
+                scan.resize(0, 0);
+            }
+        };
+        if (channels >= scheduler.workerCount()) {
+            scheduler.parallelFor(0, channels, 1, processRange);
+        } else {
+            processRange(0, channels);
+        }
+        file.unmap(mapped);
+    }
+    return true;
+}
+
+bool TiledProcessor::process(const OGPRParser &parser,
+                             const RadarPipeline &pipeline,
+                             const QString &outputPath,
+                             const qint64 memoryBudget)
+{
+    const auto shape = parser.getRadarVolumeShape(parser.activeVolumeIndex());
+    if (shape.size() != 3 || shape[0] * shape[1] * shape[2] == 0) {
+        qWarning() << "No radar volume to process";
+        return false;
+    }
+
+    const auto reader = [&parser](const int channel, const Index firstTrace, const Index count, Eigen::MatrixXf &out) {
+        parser.copyBScanRange(channel, firstTrace, count, out);
+    };
+    return process(reader, shape[0], shape[1], shape[2], pipeline, outputPath, memoryBudget);
+}
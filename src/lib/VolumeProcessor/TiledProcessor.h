@@ -0,0 +1,44 @@
+#ifndef TILEDPROCESSOR_H
+#define TILEDPROCESSOR_H
+
+#include <Eigen/Dense>
+#include <QString>
+#include <functional>
+
+class OGPRParser;
+class RadarPipeline;
+
+// 按道分块流式处理放不进内存的长测线。
+// 每块读入各通道的一段道，两侧多读 RadarPipeline::traceHalo 道重叠，处理后只写回中间的有效道，
+// 结果与整条测线一次处理相同。块按行进方向顺序推进，读入下一块与处理当前块同时进行，
+// 输入与输出都只顺序访问一遍。
+// 输出为不带文件头的 float32 电压文件，布局与 VolumeProcessor 的结果相同 (samples, channels, traces)，
+// 每块只映射自己的输出区域，写完即解除映射
+class TiledProcessor
+{
+public:
+    using Index = Eigen::Index;
+    // 读取通道 channel 的 [firstTrace, firstTrace + count) 道：(samples, count)，在后台线程调用
+    using TraceReader = std::function<void(int channel, Index firstTrace, Index count, Eigen::MatrixXf &out)>;
+
+    // 输入块（含预读的下一块与处理时的临时矩阵）占用内存的默认上限
+    static constexpr qint64 kDefaultMemoryBudget = 256 * 1024 * 1024;
+
+    // 处理 channels 个通道、每通道 traces 道的数据，写入 outputPath。
+    // 流水线含需要整条测线的步骤（自适应背景去除、标准化）时无法分块，返回 false
+    static bool process(const TraceReader &reader,
+                        Index samples,
+                        Index channels,
+                        Index traces,
+                        const RadarPipeline &pipeline,
+                        const QString &outputPath,
+                        qint64 memoryBudget = kDefaultMemoryBudget);
+
+    // 处理 parser 当前数据体，以切片为道。以映射方式加载时数据直接从磁盘流式读取
+    static bool process(const OGPRParser &parser,
+                        const RadarPipeline &pipeline,
+                        const QString &outputPath,
+                        qint64 memoryBudget = kDefaultMemoryBudget);
+};
+
+#endif // TILEDPROCESSOR_H
@@ -0,0 +1,106 @@
+#include "VolumeProcessor.h"
+#include "OGPRParser.h"
+#include "ParallelScheduler.h"
+#include "RadarPipeline.h"
+#include <QDebug>
+#include <type_traits>
+
+namespace {
+
+using Index = Eigen::Index;
+using Stride = Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>;
+
+// 数据体 (samples, channels, slices) 中一个通道的 BScan 或一个深度的 CScan
+template<typename Scalar>
+auto scanOf(Scalar *volume,
+            const Index samples,
+            const Index channels,
+            const Index slices,
+            const VolumeProcessor::Orientation orientation,
+            const Index index)
+{
+    using Matrix = std::conditional_t<std::is_const_v<Scalar>, const Eigen::MatrixXf, Eigen::MatrixXf>;
+    using ScanMap = Eigen::Map<Matrix, 0, Stride>;
+    if (orientation == VolumeProcessor::Orientation::Channels) {
+        return ScanMap(volume + index * samples, samples, slices, Stride(samples * channels, 1));
+    }
+    return ScanMap(volume + index, channels, slices, Stride(samples * channels, samples));
+}
+
+// copyScan(index, scan) 取出第 index 幅图像，处理后写回 out
+template<typename CopyScan>
+void processScans(const Index samples,
+                  const Index channels,
+                  const Index slices,
+                  const RadarPipeline &pipeline,
+                  Eigen::Tensor<float, 3> &out,
+                  const VolumeProcessor::Orientation orientation,
+                  CopyScan copyScan)
+{
+    if (out.dimension(0) != samples || out.dimension(1) != channels || out.dimension(2) != slices) {
+        out.resize(samples, channels, slices);
+    }
+    const Index scans = orientation == VolumeProcessor::Orientation::Channels ? channels : samples;
+
+    const auto processRange = [&](const std::int64_t first, const std::int64_t last) {
+        Eigen::MatrixXf scan;
+        for (Index index = first; index < last; ++index) {
+            copyScan(index, scan);
+            pipeline.run(scan);
+            scanOf(out.data(), samples, channels, slices, orientation, index) = scan;
+        }
+    };
+
+    auto &scheduler = ParallelScheduler::instance();
+    if (scans >= scheduler.workerCount()) {
+        // 图像间并行，每个区间复用一个工作矩阵
+        scheduler.parallelFor(0, scans, 1, processRange);
+    } else {
+        processRange(0, scans);
+    }
+}
+
+} // namespace
+
+bool VolumeProcessor::process(const OGPRParser &parser,
+                              const RadarPipeline &pipeline,
+                              Eigen::Tensor<float, 3> &out,
+                              const Orientation orientation)
+{
+    const auto shape = parser.getRadarVolumeShape(parser.activeVolumeIndex());
+    if (shape.size() != 3 || shape[0] * shape[1] * shape[2] == 0) {
+        qWarning() << "No radar volume to process";
+        return false;
+    }
+
+    const auto copyScan = [&](const Index index, Eigen::MatrixXf &scan) {
+        if (orientation == Orientation::Channels) {
+            parser.copyBScan(int(index), scan);
+        } else {
+            parser.copyCScan(int(index), scan);
+        }
+    };
+    processScans(shape[0], shape[1], shape[2], pipeline, out, orientation, copyScan);
+    return true;
+}
+
+bool VolumeProcessor::process(const Eigen::Tensor<float, 3> &in,
+                              const RadarPipeline &pipeline,
+                              Eigen::Tensor<float, 3> &out,
+                              const Orientation orientation)
+{
+    if (in.size() == 0) {
+        qWarning() << "No radar volume to process";
+        return false;
+    }
+
+    const Index samples = in.dimension(0);
+    const Index channels = in.dimension(1);
+    const Index slices = in.dimension(2);
+    // 原地处理时每幅图像先拷出再写回，各幅互不重叠
+    const auto copyScan = [&](const Index index, Eigen::MatrixXf &scan) {
+        scan = scanOf(in.data(), samples, channels, slices, orientation, index);
+    };
+    processScans(samples, channels, slices, pipeline, out, orientation, copyScan);
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef VOLUMEPROCESSOR_H
+#define VOLUMEPROCESSOR_H
+
+#include <Eigen/Dense>
+#include <unsupported/Eigen/CXX11/Tensor>
+
+class OGPRParser;
+class RadarPipeline;
+
+// 把同一条处理流水线作用于整个数据体。
+// 按通道处理时每个通道的 BScan (samples, slices) 为一幅图像，按深度处理时每个深度的 CScan (channels, slices) 为一幅；
+// 图像数不少于工作线程数时图像间并行、流水线内部串行，否则逐幅处理、流水线内部并行。
+// 结果写入预先分配的 (samples, channels, slices) 电压数据体，与 VolumeCache、OGPRWriter 的布局相同
+class VolumeProcessor
+{
+public:
+    enum class Orientation {
+        Channels,
+        DepthSlices
+    };
+
+    // 处理 parser 当前数据体。out 尺寸不符时重新分配，否则原地覆盖
+    static bool process(const OGPRParser &parser,
+                        const RadarPipeline &pipeline,
+                        Eigen::Tensor<float, 3> &out,
+                        Orientation orientation = Orientation::Channels);
+
+    // 处理内存中的 (samples, channels, slices) 数据体，in 与 out 可以是同一个对象
+    static bool process(const Eigen::Tensor<float, 3> &in,
+                        const RadarPipeline &pipeline,
+                        Eigen::Tensor<float, 3> &out,
+                        Orientation orientation = Orientation::Channels);
+};
+
+#endif // VOLUMEPROCESSOR_H
@@ -1,11 +1,16 @@
 ﻿#include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <qqml.h>
+#include "OGPRAsyncLoader.h"
 
 int main(int argc, char *argv[])
 {
     QGuiApplication app(argc, argv);
     
+    // OGPRParser 库不属于 QML 模块，在此注册异步加载器
+    qmlRegisterType<OGPRAsyncLoader>("OGPRAnnotator", 1, 0, "OGPRAsyncLoader");
+
     QQmlApplicationEngine engine;
     
     
@@ -0,0 +1,68 @@
+// 负载 MD5 校验：默认选项（Auto，拷贝模式下等同 Verify）解析完好的文件成功，
+// 改动一个负载字节后解析失败
+
+#include "OGPRParser.h"
+#include "OGPRWriter.h"
+#include <QDebug>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace {
+
+bool check(const bool condition, const char *message)
+{
+    if (!condition) {
+        qWarning() << "FAILED:" << message;
+    }
+    return condition;
+}
+
+// 把文件中 offset 处的字节取反
+bool flipByte(const QString &filePath, const qint64 offset)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadWrite) || !file.seek(offset)) {
+        return false;
+    }
+    char byte = 0;
+    if (!file.getChar(&byte) || !file.seek(offset)) {
+        return false;
+    }
+    return file.putChar(char(~byte));
+}
+
+} // namespace
+
+int main()
+{
+    QTemporaryDir dir;
+    if (!check(dir.isValid(), "create temporary directory")) {
+        return 1;
+    }
+    const QString filePath = dir.filePath("volume.ogpr");
+
+    Eigen::Tensor<float, 3> volume(64, 4, 32);
+    volume.setRandom();
+    if (!check(OGPRWriter::writeVolume(filePath, volume), "write volume")) {
+        return 1;
+    }
+
+    bool ok = true;
+    {
+        OGPRParser parser;
+        ok &= check(parser.parseOGPRFile(filePath), "parse intact file with default options");
+        ok &= check(parser.checksumStatus(false) == OGPRParser::ChecksumStatus::Valid,
+                    "intact file reports a valid checksum");
+    }
+
+    // 最后一个采样字节位于结尾（33 字节）之前，只在负载 MD5 中出现
+    const qint64 payloadByte = QFile(filePath).size() - 33 - 1;
+    ok &= check(flipByte(filePath, payloadByte), "corrupt one payload byte");
+    {
+        OGPRParser parser;
+        ok &= check(!parser.parseOGPRFile(filePath), "parse corrupt file with default options fails");
+        ok &= check(parser.checksumStatus(false) == OGPRParser::ChecksumStatus::Mismatch,
+                    "corrupt file reports a checksum mismatch");
+    }
+    return ok ? 0 : 1;
+}